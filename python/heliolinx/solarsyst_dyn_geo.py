@@ -7,7 +7,7 @@ import heliolinx as hl
 SSHORT = 'S20'
 SMIN = 'S5'
 
-__all__ = ["celeproj", "celedeproj", "make_image_table", "read_ObsCodes", "parse_ObsCodes", "load_earth_ephemerides", "image_add_observerpos"]
+__all__ = ["celeproj", "celedeproj", "make_image_table", "read_ObsCodes", "parse_ObsCodes", "load_earth_ephemerides", "image_add_observerpos", "obsarr_to_observatory", "make_hlimage_table"]
 
 intype = np.dtype(list(dict(
     MJD=float,
@@ -134,6 +134,13 @@ point3d_index = np.dtype(list(dict(
     index=int,
 ).items()))
 
+observatory = np.dtype(list(dict(
+    obscode=SMIN,
+    obslon=float,
+    plxcos=float,
+    plxsin=float,
+).items()))
+
 def celeproj(ra, dec, **kwargs):
     """ Project an RA, Dec position onto the Cartesian unit sphere """
     x=np.cos(np.pi*dec/180.0)*np.cos(np.pi*ra/180.0)
@@ -157,7 +164,8 @@ def celedeproj(cartvec, **kwargs):
     #This function needs some error catching, which I don't know how to do in python.
 
 def make_image_table(detection_table, **kwargs):
-    """  Construct an image table from an input detection catalog with MJD, RA, Dec, and obscode """
+    """  Construct an image table from an input detection catalog with MJD, RA, Dec, and obscode.
+         Slow for large catalogs: use make_hlimage_table instead. """
     imct=0
     timetol = 2.0
     imarray = np.array([detection_table['MJD'][0],detection_table['RA'][0],detection_table['Dec'][0]],ndmin=2)
@@ -270,7 +278,8 @@ def load_earth_ephemerides(fn, **kwargs):
 
 
 def image_add_observerpos(image, obsarr, earthpos, **kwargs):
-    """ Given an input image file, calculate the observer's heliocentric position and velocity at the time of every image """
+    """ Given an input image file, calculate the observer's heliocentric position and velocity at the time of every image.
+         Slow for large catalogs: use make_hlimage_table instead. """
     
     b=np.empty((len(image),),dtype=hlimage) #new
     for i in range(len(image)) :
@@ -298,3 +307,29 @@ def image_add_observerpos(image, obsarr, earthpos, **kwargs):
         b['exptime'][i] = image[i][4]
 
     return(b)
+
+
+def obsarr_to_observatory(obsarr, **kwargs):
+    """ Convert the string array from read_ObsCodes or parse_ObsCodes into an observatory array for the C++ code """
+    obsarr = np.asarray(obsarr)
+    b = hl.create_observatory(len(obsarr))
+    if(len(obsarr)==0): return(b)
+    b['obscode'] = np.char.strip(obsarr[:,0])
+    # Entries with blank location fields (e.g., space-based observatories) get zeros
+    for j,name in enumerate(('obslon','plxcos','plxsin')):
+        col = np.char.strip(obsarr[:,j+1])
+        b[name] = np.where(col=='', '0', col).astype(float)
+    return(b)
+
+
+def make_hlimage_table(detection_table, obsarr, earthpos, time_offset=0.0, **kwargs):
+    """ Time-sort an hldet detection catalog and construct its image table, with the observer's
+        heliocentric position and velocity for every image, in a single C++ pass.
+        obsarr may be the output of read_ObsCodes or an observatory array; earthpos may
+        be the output of load_earth_ephemerides or an EarthState array.
+        Returns the time-sorted detections and the image table. """
+    if(np.asarray(obsarr).dtype.names is None): obsarr = obsarr_to_observatory(obsarr)
+    ep = hl.create_EarthState(len(earthpos))
+    for newname,oldname in zip(ep.dtype.names, earthpos.dtype.names):
+        ep[newname] = earthpos[oldname]
+    return(hl.makeImageTable(detection_table, obsarr, ep, time_offset))
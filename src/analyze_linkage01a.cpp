@@ -20,11 +20,12 @@
 // The observation file must contain observations in heliolinc's hldet format.
 static void show_usage()
 {
-  cerr << "Usage: evertrace01a -cfg configfile -observations obsfile -kepspan time_span_for_Keplerian_fit(day) -minchi min_chi_change -rmsthresh astrometric_rms_threshold -obscode obscodefile -maxiter maxiter -ptpow point_num_exponent -nightpow night_num_exponent -timepow timespan_exponent -rmspow astrom_rms_exponent -outfile outfile -linkfile linkfile -verbose verbosity\n";
+  cerr << "Usage: evertrace01a -cfg configfile -observations obsfile -kepspan time_span_for_Keplerian_fit(day) -minchi min_chi_change -rmsthresh astrometric_rms_threshold -obscode obscodefile -maxiter maxiter -ptpow point_num_exponent -nightpow night_num_exponent -timepow timespan_exponent -rmspow astrom_rms_exponent -outfile outfile -linkfile linkfile -verbose verbosity -profile profile_file\n";
 }
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   double kepspan=15.0;
   long double minchichange = 0.001l;
   long i,j,k;
@@ -36,6 +37,7 @@ int main(int argc, char *argv[])
   string obsfile,obscodefile;
   vector <hldet> detvec = {};
   vector <observatory> observatory_list = {};
+  unordered_map <int, long> obsindex;
   string imfile;
   string Earthfile,Sunfile,planetfile;
   string spaceobsfile;
@@ -469,12 +471,28 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   cout.precision(17);  
   cout << "input configuration file " << configfile << "\n";
   cout << "input observations file " << obsfile << "\n";
@@ -559,6 +577,7 @@ int main(int argc, char *argv[])
   }
   
   cout << "Read " << observatory_list.size() << " lines from observatory code file " << obscodefile << "\n";
+  make_obscode_index(observatory_list, obsindex);
   if(verbose>=2) {
     for(i=0;i<long(observatory_list.size());i++) {
       cout << observatory_list[i].obscode << " " << observatory_list[i].obslon << " " << observatory_list[i].plxcos << " " << observatory_list[i].plxsin << "\n";
@@ -598,7 +617,7 @@ int main(int argc, char *argv[])
   // Calculate the observer's heliocentric position at the time of each observation.
   observer_statevecs = observer_heliostate = {};
   for(obsct=0;obsct<obsnum;obsct++) {
-    status = obscode_lookup(observatory_list,detvec[obsct].obscode,obslon,plxcos,plxsin);
+    status = obscode_lookup(obsindex,observatory_list,detvec[obsct].obscode,obslon,plxcos,plxsin);
     if(verbose>0) cout << "Detection " << obsct << " is from obscode " << detvec[obsct].obscode << ", coords " << obslon << " " << plxcos << " " << plxsin << "\n";
     if(status>0) {
       cerr << "ERROR: obscode_lookup failed for observatory code " << detvec[obsct].obscode << "\n";
@@ -1026,6 +1045,7 @@ int main(int argc, char *argv[])
   cout << sqrt(crossquad*crossquad + alongquad*alongquad)  << "\t\tTotal acceleration\n";
   
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "analyze_linkage01a");
   return(0);
 }
 
@@ -38,6 +38,7 @@ int main(int argc, char *argv[])
   string obsfile,obscodefile;
   vector <hldet> detvec = {};
   vector <observatory> observatory_list = {};
+  unordered_map <int, long> obsindex;
   string imfile;
   string Earthfile,Sunfile,planetfile;
   string spaceobsfile;
@@ -636,6 +637,7 @@ int main(int argc, char *argv[])
   }
   
   cout << "Read " << observatory_list.size() << " lines from observatory code file " << obscodefile << "\n";
+  make_obscode_index(observatory_list, obsindex);
   if(verbose>=2) {
     for(i=0;i<long(observatory_list.size());i++) {
       cout << observatory_list[i].obscode << " " << observatory_list[i].obslon << " " << observatory_list[i].plxcos << " " << observatory_list[i].plxsin << "\n";
@@ -675,7 +677,7 @@ int main(int argc, char *argv[])
   // Calculate the observer's heliocentric position at the time of each observation.
   observer_statevecs = observer_heliostate = {};
   for(obsct=0;obsct<obsnum;obsct++) {
-    status = obscode_lookup(observatory_list,detvec[obsct].obscode,obslon,plxcos,plxsin);
+    status = obscode_lookup(obsindex,observatory_list,detvec[obsct].obscode,obslon,plxcos,plxsin);
     if(verbose>0) cout << "Detection " << obsct << " is from obscode " << detvec[obsct].obscode << ", coords " << obslon << " " << plxcos << " " << plxsin << "\n";
     if(status>0) {
       cerr << "ERROR: obscode_lookup failed for observatory code " << detvec[obsct].obscode << "\n";
@@ -3,6 +3,16 @@
 // to the problem of calculating a hypothesis matrix for heliolinc.
 // Interpolates an input file giving sampling in each dimension,
 // as a function of heliocentric distance.
+//
+// October 18, 2026: added an adaptive mode, invoked by supplying
+// the hypothesis grid (-prevgrid) and cluster summary file (-prevsum)
+// from a previous heliolinc run, and optionally a file giving the
+// cost of each hypothesis (-hypcost). Rather than constructing a grid
+// from the interpolation file, the program then prunes the previous
+// grid down to the hypotheses that contributed unique linkages, up to
+// a target completeness and cost budget, and optionally refines it
+// around the most productive hypotheses. See heliohyp_adapt in
+// solarsyst_dyn_geo01.cpp.
 
 #include "solarsyst_dyn_geo01.h"
 #include "cmath"
@@ -11,12 +21,15 @@
 
 static void show_usage()
 {
-  cerr << "Usage: calc_heliohypmat -interp interpolation file -mindist minimum distance (AU) -maxdist maximum distance (AU) -distfac factor by which to scale distance sampling -velfac factor by which to scale velocity sampling -accfac factor by which to scale acceleration sampling -middle usemiddle -outfile output file\n";
+  cerr << "Usage: calc_heliohypmat -interp interpolation file -mindist minimum distance (AU) -maxdist maximum distance (AU) -distfac factor by which to scale distance sampling -velfac factor by which to scale velocity sampling -accfac factor by which to scale acceleration sampling -middle usemiddle -outfile output file -profile profile_file\n";
+  cerr << "\nor, for adaptive mode:\n\n";
+  cerr << "calc_heliohypmat -prevgrid hypothesis file from previous heliolinc run -prevsum cluster summary file from previous heliolinc run -hypcost per-hypothesis cost file -costcol column of cost file holding the cost -completeness target fraction of unique linkages to retain -budget maximum total cost -refine yield fraction above which hypotheses are refined -pureonly 1=count_only_PURE_linkages -outfile output file\n";
 
 }
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   double mindist = 1.5l;
   double maxdist = 100.0l;
   double diststep = 1.0l;
@@ -40,6 +53,13 @@ int main(int argc, char *argv[])
   vector <double> distvec,distsampvec,velsampvec,accsampvec;
   long ilo,ihi;
   string lnfromfile;
+  string prevgridfile,prevsumfile,hypcostfile;
+  int costcol=2;
+  double completeness=1.0l;
+  double costbudget=0.0l;
+  double refinefrac=0.0l;
+  int pureonly=0;
+  int status=0;
   
   if(argc<5) {
     show_usage();
@@ -136,6 +156,94 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-prevgrid" || string(argv[i]) == "-prevhyp" || string(argv[i]) == "--prevgrid" || string(argv[i]) == "--previous_grid") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	prevgridfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Previous hypothesis grid keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-prevsum" || string(argv[i]) == "-sum" || string(argv[i]) == "--prevsum" || string(argv[i]) == "--previous_summary") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	prevsumfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Previous cluster summary keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-hypcost" || string(argv[i]) == "-costfile" || string(argv[i]) == "--hypcost" || string(argv[i]) == "--hypothesis_cost") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	hypcostfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Hypothesis cost file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-costcol" || string(argv[i]) == "--costcol") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	costcol=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Cost column keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-completeness" || string(argv[i]) == "-complete" || string(argv[i]) == "--completeness") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	completeness=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Target completeness keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-budget" || string(argv[i]) == "-maxcost" || string(argv[i]) == "--budget") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	costbudget=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Cost budget keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-refine" || string(argv[i]) == "-refinefrac" || string(argv[i]) == "--refine") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	refinefrac=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Refinement fraction keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-pureonly" || string(argv[i]) == "-pure" || string(argv[i]) == "--pureonly") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	pureonly=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Pure-only keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     }  else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose" || string(argv[i]) == "--VERBOSE" || string(argv[i]) == "--VERB") {
       if(i+1 < argc) {
 	//There is still something to read;
@@ -147,12 +255,87 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
+
+  if(prevgridfile.size()>0 || prevsumfile.size()>0) {
+    // Adaptive mode: prune and refine the grid from a previous run.
+    vector <hlradhyp> radhyp,outhyp;
+    vector <hlclust> prevclust;
+    vector <double> hypcost;
+    if(prevgridfile.size()<=0 || prevsumfile.size()<=0) {
+      cout << "\nERROR: adaptive mode requires both the previous hypothesis grid and cluster summary file\n";
+      show_usage();
+      return(1);
+    } else if(outfile.size()<=0) {
+      cout << "\nERROR: output filename is required\n";
+      show_usage();
+      return(1);
+    } else if(completeness<=0.0l || completeness>1.0l) {
+      cout << "\nERROR: target completeness must be greater than 0 and no greater than 1\n";
+      show_usage();
+      return(1);
+    }
+    cout << "Adaptive mode: previous hypothesis grid " << prevgridfile << ", cluster summary " << prevsumfile << "\n";
+    cout << "Target completeness " << completeness << ", cost budget " << costbudget << " (zero or negative means unlimited)\n";
+    status=read_radhyp_file(prevgridfile, radhyp, verbose);
+    if(status!=0) {
+      cerr << "ERROR: could not successfully read hypothesis file " << prevgridfile << "\n";
+      cerr << "read_radhyp_file returned status = " << status << ".\n";
+      return(1);
+    }
+    cout << "Read " << radhyp.size() << " hypotheses from " << prevgridfile << "\n";
+    status=read_clustersum_file(prevsumfile, prevclust, verbose);
+    if(status!=0) {
+      cerr << "ERROR: could not successfully read cluster summary file " << prevsumfile << "\n";
+      cerr << "read_clustersum_file returned status = " << status << ".\n";
+      return(1);
+    }
+    cout << "Read " << prevclust.size() << " linkages from " << prevsumfile << "\n";
+    if(hypcostfile.size()>0) {
+      status=read_hypcost_file(hypcostfile, costcol, hypcost, verbose);
+      if(status!=0) {
+	cerr << "ERROR: could not successfully read hypothesis cost file " << hypcostfile << "\n";
+	cerr << "read_hypcost_file returned status = " << status << ".\n";
+	return(1);
+      }
+      cout << "Read costs for " << hypcost.size() << " hypotheses from " << hypcostfile << "\n";
+    } else cout << "No hypothesis cost file supplied: all hypotheses will be assumed equally expensive\n";
+    status=heliohyp_adapt(radhyp, prevclust, hypcost, completeness, costbudget, refinefrac, pureonly, outhyp, verbose);
+    if(status!=0) {
+      cerr << "ERROR: heliohyp_adapt failed with status " << status << "\n";
+      return(status);
+    }
+    outstream1.open(outfile);
+    outstream1 << "#r(AU) rdot(AU/day) mean_accel\n";
+    for(i=0; i<long(outhyp.size()); i++) {
+      outstream1 << outhyp[i].HelioRad << " " << outhyp[i].R_dot << " " << outhyp[i].R_dubdot << "\n";
+    }
+    outstream1.close();
+    cout << "Wrote " << outhyp.size() << " hypotheses to " << outfile << "\n";
+    if(profilefile.size()>0) hlprof_write(profilefile, "calc_heliohypmat");
+    return(0);
+  }
   
   cout << "Distances will be probed from " << mindist << " to " << maxdist << "AU\n";
   cout << "Output file to be written is called " << outfile << "\n";
@@ -321,5 +504,6 @@ int main(int argc, char *argv[])
     dist += diststep;
   }
 	
+  if(profilefile.size()>0) hlprof_write(profilefile, "calc_heliohypmat");
   return(0);
 }
@@ -28,6 +28,7 @@ int main(int argc, char *argv[])
   vector <longpair> trail2det;
   ofstream outstream1;
   FindGlintsConfig config;  
+  config.verbose = 1; // Single image: report progress as before.
   int status = 0;
   long i = 0;
   string indetfile;
@@ -9,7 +9,7 @@
 
 static void show_usage()
 {
-  cerr << "Usage: helio_highgrade2 -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -mintimespan mintimespan -minobs min_unique_obs -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf  -outdets output detection file -verbose verbosity\n";
+  cerr << "Usage: helio_highgrade2 -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -mintimespan mintimespan -minobs min_unique_obs -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf  -outdets output detection file -verbose verbosity -profile profile_file\n";
   cerr << "\nor, at minimum:\n\n";
   cerr << "helio_highgrade2 -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -heliodist heliocentric_dist_vel_acc_file\n\n";
   cerr << "\nNote that the minimum invocation leaves some things set to defaults\n";
@@ -19,6 +19,7 @@ static void show_usage()
     
 int main(int argc, char *argv[])
 {
+  string profilefile;
   vector <hldet> detvec = {};
   vector <hldet> pairdets = {};
   vector <hlimage> image_log;
@@ -316,11 +317,27 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
   if(config.minobsnights > config.dbscan_npt) config.minobsnights = config.dbscan_npt; // Otherwise the low setting of dbscan_npt is not operative.
 
   if(argc<11)
@@ -500,5 +517,6 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "helio_highgrade");
   return(0);
 }
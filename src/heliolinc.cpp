@@ -180,7 +180,7 @@
 
 static void show_usage()
 {
-  cerr << "Usage: heliolinc -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf  -outsum summary_file -clust2det clust2detfile -verbose verbosity\n";
+  cerr << "Usage: heliolinc -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf -prescreen 0=off_1=coarse_prescreen_2=validate_prescreen -outsum summary_file -clust2det clust2detfile -verbose verbosity -profile profile_file\n";
   cerr << "\nor, at minimum:\n\n";
   cerr << "heliolinc -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file\n";
   cerr << "\nNote that the minimum invocation leaves some things set to defaults\n";
@@ -190,6 +190,7 @@ static void show_usage()
     
 int main(int argc, char *argv[])
 {
+  string profilefile;
   vector <hldet> detvec = {};
   vector <hldet> pairdets = {};
   vector <hlimage> image_log;
@@ -454,6 +455,17 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    }  else if(string(argv[i]) == "-prescreen" || string(argv[i]) == "-coarse" || string(argv[i]) == "--prescreen") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.prescreen=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Prescreen keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose" || string(argv[i]) == "--VERBOSE" || string(argv[i]) == "--VERB") {
       if(i+1 < argc) {
 	//There is still something to read;
@@ -500,11 +512,27 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
   if(config.minobsnights > config.dbscan_npt) config.minobsnights = config.dbscan_npt; // Otherwise the low setting of dbscan_npt is not operative.
 
   if(argc<11)
@@ -586,6 +614,8 @@ int main(int argc, char *argv[])
   else cout << "Using f and g functions for Keplerian integration\n";
   if(default_max_v_inf==1) cout << "Defaulting to maximum v_inf relative to the sun = " << config.max_v_inf << " km/sec\n";
   else cout << "Maximum v_inf relative to the sun is " << config.max_v_inf << " km\n";
+  if(config.prescreen==1) cout << "Coarse pre-screening of state vectors will be performed before clustering\n";
+  else if(config.prescreen==2) cout << "Coarse pre-screening will be validated against an exhaustive search\n";
   if(default_sumfile==1) cout << "WARNING: using default name " << sumfile << " for summary output file\n";
   else cout << "summary output file " << sumfile << "\n";
   if(default_clust2detfile==1) cout << "WARNING: using default name " << clust2detfile << " for output clust2det file\n";
@@ -694,5 +724,6 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "heliolinc");
   return(0);
 }
@@ -180,7 +180,7 @@
 
 static void show_usage()
 {
-  cerr << "Usage: heliolinc -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf  -outsum summary_file -clust2det clust2detfile -verbose verbosity\n";
+  cerr << "Usage: heliolinc -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf -compact 1=compact_16bit_state_vectors -float32 0=double_1=float32_2=validate_float32 -outsum summary_file -hypstats per_hypothesis_statistics_file -clust2det clust2detfile -verbose verbosity -profile profile_file -loglevel 0=errors_only_2=summaries_3=progress_4=verbose_diagnostics\n";
   cerr << "\nor, at minimum:\n\n";
   cerr << "heliolinc -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file\n";
   cerr << "\nNote that the minimum invocation leaves some things set to defaults\n";
@@ -190,6 +190,7 @@ static void show_usage()
     
 int main(int argc, char *argv[])
 {
+  string profilefile;
   vector <hldet> detvec = {};
   vector <hldet> pairdets = {};
   vector <hlimage> image_log;
@@ -200,9 +201,11 @@ int main(int argc, char *argv[])
   HeliolincConfig config;
   vector <hlclust> outclust;
   vector <longpair> clust2det;
+  vector <hlhypstat> hypstats;
   string imfile,pairdetfile,trackletfile,trk2detfile,planetfile,accelfile;
   string sumfile = "sumfile_test.csv";
   string clust2detfile = "clust2detfile_test.csv";
+  string hypstatfile;
   int default_clustrad, default_clustchangerad, default_npt, default_minobsnights;
   int default_mintimespan, default_mingeodist, default_maxgeodist;
   int default_geologstep,default_clust2detfile,default_sumfile;
@@ -454,6 +457,28 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    }  else if(string(argv[i]) == "-compact" || string(argv[i]) == "-compactvec" || string(argv[i]) == "--compact") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.compact=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Compact state vector keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-float32" || string(argv[i]) == "-f32" || string(argv[i]) == "--float32") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.float32=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Float32 keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose" || string(argv[i]) == "--VERBOSE" || string(argv[i]) == "--VERB") {
       if(i+1 < argc) {
 	//There is still something to read;
@@ -477,6 +502,17 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-hypstats" || string(argv[i]) == "-hypstat" || string(argv[i]) == "--hypstats" || string(argv[i]) == "--hypothesis_stats") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	hypstatfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Output per-hypothesis statistics file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else if(string(argv[i]) == "-clust2det" || string(argv[i]) == "-c2d" || string(argv[i]) == "-clust2detfile" || string(argv[i]) == "--clust2detfile" || string(argv[i]) == "--clust2det" || string(argv[i]) == "--cluster_to_detection") {
       if(i+1 < argc) {
 	//There is still something to read;
@@ -500,11 +536,38 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-loglevel" || string(argv[i]) == "-log" || string(argv[i]) == "--loglevel" || string(argv[i]) == "--log_level") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	hllog_set_level(stoi(argv[++i]));
+	i++;
+      }
+      else {
+	cerr << "Log level keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
   if(config.minobsnights > config.dbscan_npt) config.minobsnights = config.dbscan_npt; // Otherwise the low setting of dbscan_npt is not operative.
 
   if(argc<11)
@@ -586,8 +649,17 @@ int main(int argc, char *argv[])
   else cout << "Using f and g functions for Keplerian integration\n";
   if(default_max_v_inf==1) cout << "Defaulting to maximum v_inf relative to the sun = " << config.max_v_inf << " km/sec\n";
   else cout << "Maximum v_inf relative to the sun is " << config.max_v_inf << " km\n";
+  if(config.compact==1) cout << "State vectors will be quantized into compact 16-bit form for clustering\n";
+  if(config.float32==1) cout << "State vectors will be propagated to the reference time in single precision\n";
+  else if(config.float32==2) cout << "Single-precision state vectors will be validated against double precision\n";
   if(default_sumfile==1) cout << "WARNING: using default name " << sumfile << " for summary output file\n";
   else cout << "summary output file " << sumfile << "\n";
+  if(hypstatfile.size()<=0) {
+    // Write the per-hypothesis statistics alongside the summary file.
+    if(sumfile.size()>4 && sumfile.substr(sumfile.size()-4) == ".csv") hypstatfile = sumfile.substr(0,sumfile.size()-4) + "_hypstats.csv";
+    else hypstatfile = sumfile + "_hypstats.csv";
+  }
+  cout << "per-hypothesis statistics file " << hypstatfile << "\n";
   if(default_clust2detfile==1) cout << "WARNING: using default name " << clust2detfile << " for output clust2det file\n";
   else cout << "output clust2det file " << clust2detfile << "\n";
 
@@ -665,7 +737,7 @@ int main(int argc, char *argv[])
    return(1);
   }
   cout << "Read " << trk2det.size() << " data lines from trk2det file " << trk2detfile << "\n";
-  status=heliolinc_alg_lowmem(image_log, detvec, tracklets, trk2det, radhyp, earthpos, config, outclust, clust2det);
+  status=heliolinc_alg_lowmem2(image_log, detvec, tracklets, trk2det, radhyp, earthpos, config, outclust, clust2det, hypstats);
   if(status!=0) {
     cerr << "ERROR: heliolinc_alg_all failed with status " << status << "\n";
     return(status);
@@ -693,6 +765,13 @@ int main(int argc, char *argv[])
     outstream1 << clust2det[clustct].i1 << "," << clust2det[clustct].i2 << "\n";
   }
   outstream1.close();
+  cout << "Writing statistics for " << hypstats.size() << " hypotheses to " << hypstatfile << "\n";
+  status=write_hypstat_file(hypstatfile, hypstats);
+  if(status!=0) {
+    cerr << "ERROR: could not write per-hypothesis statistics file " << hypstatfile << "\n";
+    return(status);
+  }
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "heliolinc_lowmem");
   return(0);
 }
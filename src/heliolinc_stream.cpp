@@ -0,0 +1,715 @@
+// October 18, 2026: heliolinc_stream.cpp:
+// Incremental (nightly streaming) version of heliolinc. Rather than
+// re-running make_tracklets and heliolinc over the entire multi-night
+// window every night, when only one night of tracklets is new, run
+// make_tracklets on the new night alone, and supply its output to
+// heliolinc_stream together with the stream state saved by the
+// previous night's run. The stream state consists of the image, paired
+// detection, tracklet, and trk2det files for the current window, plus
+// a file with the integerized state vectors of every tracklet in the
+// window under every heliocentric hypothesis. heliolinc_stream expires
+// images older than the window length (in days) before the latest new
+// image, appends the new night, calculates state vectors only for the
+// new tracklets, and range-queries only the neighborhoods of the new
+// state vectors, so that only new or changed linkages -- those including
+// at least one new tracklet -- are written to the output summary and
+// clust2det files. Detection indices in the clust2det file refer to the
+// paired detection file of the output stream state.
+//
+// The reference MJD and the characteristic time scale for clustering
+// are fixed when the state is created, and persisted. If the center of
+// the window drifts more than rebasedays from the reference MJD, it is
+// reset to the window center and all state vectors are recalculated.
+// The same heliocentric hypothesis file must be used for every night;
+// if the number of hypotheses changes, all state vectors are recalculated.
+// On the first night, omit -statein: all linkages are then new.
+
+#include "solarsyst_dyn_geo01.h"
+#include "cmath"
+
+static void show_usage()
+{
+  cerr << "Usage: heliolinc_stream -imgs new_night_imfile -pairdets new_night_paired_detection_file -tracklets new_night_tracklet_file -trk2det new_night_tracklet-to-detection_file -statein input_state_prefix -stateout output_state_prefix -window window_length_days -rebase max_reference_MJD_drift_days -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf -prescreen 0=off_1=coarse_prescreen_2=validate_prescreen -outsum summary_file -clust2det clust2detfile -verbose verbosity -profile profile_file\n";
+  cerr << "\nor, at minimum:\n\n";
+  cerr << "heliolinc_stream -imgs new_night_imfile -pairdets new_night_paired_detection_file -tracklets new_night_tracklet_file -trk2det new_night_tracklet-to-detection_file -stateout output_state_prefix -obspos observer_position_file -heliodist heliocentric_dist_vel_acc_file\n";
+  cerr << "\nNote that the minimum invocation leaves some things set to defaults\n";
+  cerr << "that you may well wish to specify: in particular, the output file names.\n";
+  cerr << "The stream state consists of the files prefix_images.txt, prefix_pairdets.csv,\n";
+  cerr << "prefix_tracklets.csv, prefix_trk2det.csv, and prefix_statevecs.csv\n";
+}
+    
+int main(int argc, char *argv[])
+{
+  string profilefile;
+  vector <hldet> detvec = {};
+  vector <hlimage> image_log;
+  vector <tracklet> tracklets;
+  vector <longpair> trk2det;
+  vector <hldet> newdets = {};
+  vector <hlimage> newimages;
+  vector <tracklet> newtracklets;
+  vector <longpair> newtrk2det;
+  vector <hldet> olddets = {};
+  vector <hlimage> oldimages;
+  vector <tracklet> oldtracklets;
+  vector <longpair> oldtrk2det;
+  vector <vector <point6ix2>> hypstate;
+  vector <hlradhyp> radhyp;
+  vector <EarthState> earthpos;
+  HeliolincConfig config;
+  vector <hlclust> outclust;
+  vector <longpair> clust2det;
+  string imfile,pairdetfile,trackletfile,trk2detfile,planetfile,accelfile;
+  string stateinprefix,stateoutprefix;
+  string sumfile = "sumfile_test.csv";
+  string clust2detfile = "clust2detfile_test.csv";
+  double windowdays = 14.0l;
+  double rebasedays = 3.0l;
+  double MJDref = 0.0l;
+  double chartimescale = 0.0l;
+  double cutoffMJD, minMJD, maxMJD, centerMJD;
+  cutoffMJD = minMJD = maxMJD = centerMJD = 0.0l;
+  long statehypnum = 0;
+  long firstnew = 0;
+  long firstcompute = 0;
+  int recompute = 0;
+  int default_clustrad, default_clustchangerad, default_npt, default_minobsnights;
+  int default_mintimespan, default_mingeodist, default_maxgeodist;
+  int default_geologstep,default_clust2detfile,default_sumfile;
+  int default_mingeoobs, default_minimpactpar;
+  int default_use_univar, default_max_v_inf;
+  default_clustrad = default_clustchangerad = default_npt = default_minobsnights = 1;
+  default_mintimespan = 1;
+  default_mingeodist = default_maxgeodist = default_geologstep = 1;
+  default_clust2detfile = default_sumfile = 1;
+  default_mingeoobs = default_minimpactpar = 1;
+  default_use_univar = default_max_v_inf = 1;
+  ofstream outstream1;
+  long i=0;
+  long clustct=0;
+  int status=0;
+  
+  i=1;
+  while(i<argc) {
+    cout << "Checking out argv[" << i << "] = " << argv[i] << ".\n";
+    if(string(argv[i]) == "-pairdet" || string(argv[i]) == "-pairdets" || string(argv[i]) == "-detpairs") {
+      if(i+1 < argc) {
+	//There is still something to read;
+        pairdetfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Input paired detection file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-i" || string(argv[i]) == "-imgs" || string(argv[i]) == "-inimgs" || string(argv[i]) == "-img" || string(argv[i]) == "--inimgs" || string(argv[i]) == "--img" || string(argv[i]) == "--image" || string(argv[i]) == "--images") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	imfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Image file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-tracklets" || string(argv[i]) == "-tracklet" || string(argv[i]) == "-tf" || string(argv[i]) == "-trkfile" || string(argv[i]) == "-trackletfile" || string(argv[i]) == "--trackletfile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	trackletfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Input pair file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-trk2det" || string(argv[i]) == "-t2d" || string(argv[i]) == "-tracklet2detection" || string(argv[i]) == "-trk2detfile" || string(argv[i]) == "--tracklet2detection") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	trk2detfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Input pair file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-obspos" || string(argv[i]) == "-op" || string(argv[i]) == "-obsvec" || string(argv[i]) == "--observer" || string(argv[i]) == "--observer_position" || string(argv[i]) == "--observer_statevec") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	planetfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Observer position file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-heliodist" || string(argv[i]) == "-hd" || string(argv[i]) == "-heliodva" || string(argv[i]) == "-hdva" || string(argv[i]) == "--heliodistvelacc" || string(argv[i]) == "--heliodva") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	accelfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Heliocentric distance, velocity, and acceleration\nfile keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-clustrad" || string(argv[i]) == "-cr" || string(argv[i]) == "-crad" || string(argv[i]) == "-cluster" || string(argv[i]) == "--clustrad" || string(argv[i]) == "--clusterradius" || string(argv[i]) == "--clusterrad") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.clustrad=stod(argv[++i]);
+	default_clustrad = 0;
+	i++;
+      }
+      else {
+	cerr << "Clustering radius keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-clustchangerad" || string(argv[i]) == "-clustchangerad" || string(argv[i]) == "-clustchangerad") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.clustchangerad = stod(argv[++i]); 
+	default_clustchangerad = 0;
+	i++;
+      }
+      else {
+	cerr << "Transition distance for cluster scaling keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-npt" || string(argv[i]) == "-npoints" || string(argv[i]) == "-minpts" || string(argv[i]) == "-np" || string(argv[i]) == "--npt" || string(argv[i]) == "--dbscan_npt" || string(argv[i]) == "--DBSCANnpt") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.dbscan_npt=stoi(argv[++i]);
+	default_npt = 0;
+	i++;
+      }
+      else {
+	cerr << "DBSCAN npt keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-minobsnights" || string(argv[i]) == "-mon" || string(argv[i]) == "-minobs" || string(argv[i]) == "-minobsnight" || string(argv[i]) == "--minobsnights" || string(argv[i]) == "--minobsnight" || string(argv[i]) == "-minobsn") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.minobsnights=stoi(argv[++i]);
+	default_minobsnights = 0;
+	i++;
+      }
+      else {
+	cerr << "Min. number of observing nights keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-mintimespan" || string(argv[i]) == "-mts" || string(argv[i]) == "-minspan" || string(argv[i]) == "-mintspan" || string(argv[i]) == "--mts" || string(argv[i]) == "--mintimespan" || string(argv[i]) == "--mintspan") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.mintimespan=stod(argv[++i]);
+	default_mintimespan = 0;
+	i++;
+      }
+      else {
+	cerr << "Minimum time span keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-mingeodist" || string(argv[i]) == "-mingd" || string(argv[i]) == "-mingeo" || string(argv[i]) == "-mingeod" || string(argv[i]) == "--mingeodist" || string(argv[i]) == "--minimum_geocentr_dist") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.mingeodist=stod(argv[++i]);
+	default_mingeodist = 0;
+	i++;
+      }
+      else {
+	cerr << "Minimum geocentric distance keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-maxgeodist" || string(argv[i]) == "-maxgd" || string(argv[i]) == "-maxgeo" || string(argv[i]) == "-maxgeod" || string(argv[i]) == "--maxgeodist" || string(argv[i]) == "--maximum_geocentr_dist") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.maxgeodist=stod(argv[++i]);
+	default_maxgeodist = 0;
+	i++;
+      }
+      else {
+	cerr << "Maximum geocentric distance keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-geologstep" || string(argv[i]) == "-gls" || string(argv[i]) == "-geostep" || string(argv[i]) == "-glogstep" || string(argv[i]) == "--geologstep" || string(argv[i]) == "--geodistlogstep" || string(argv[i]) == "--geodiststep") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.geologstep=stod(argv[++i]);
+	default_geologstep = 0;
+	i++;
+      }
+      else {
+	cerr << "Geocentric distance logarithmic step keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-mingeoobs" || string(argv[i]) == "-mgo" || string(argv[i]) == "-minobsdist" || string(argv[i]) == "-mindistobs" || string(argv[i]) == "--min_geocentric_obsdist" || string(argv[i]) == "--min_observation_distance" || string(argv[i]) == "--mingeoobs") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.mingeoobs=stod(argv[++i]);
+	default_mingeoobs = 0;
+	i++;
+      }
+      else {
+	cerr << "Minimum geocentric distance at observation keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-minimpactpar" || string(argv[i]) == "-mip" || string(argv[i]) == "-minimp" || string(argv[i]) == "-minimppar" || string(argv[i]) == "--minimum_impact_parameter" || string(argv[i]) == "--minimpactpar" || string(argv[i]) == "--min_impact_par") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.minimpactpar=stod(argv[++i]);
+	default_minimpactpar = 0;
+	i++;
+      }
+      else {
+	cerr << "Minimum impact parameter keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-useunivar" || string(argv[i]) == "-use_univar" || string(argv[i]) == "-univar" || string(argv[i]) == "-universalvar") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.use_univar=stoi(argv[++i]);
+	default_use_univar = 0;
+	i++;
+      }
+      else {
+	cerr << "Minimum impact parameter keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-vinf" || string(argv[i]) == "-maxvinf" || string(argv[i]) == "-max_v_inf") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.max_v_inf=stod(argv[++i]);
+	default_max_v_inf = 0;
+	i++;
+      }
+      else {
+	cerr << "Minimum impact parameter keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    }  else if(string(argv[i]) == "-prescreen" || string(argv[i]) == "-coarse" || string(argv[i]) == "--prescreen") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.prescreen=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Prescreen keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose" || string(argv[i]) == "--VERBOSE" || string(argv[i]) == "--VERB") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.verbose=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Verbosity keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-outsum" || string(argv[i]) == "-sum" || string(argv[i]) == "-rms" || string(argv[i]) == "-outrms" || string(argv[i]) == "-or" || string(argv[i]) == "--outsummaryfile" || string(argv[i]) == "--outsum" || string(argv[i]) == "--sum") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	sumfile=argv[++i];
+	default_sumfile = 0;
+	i++;
+      }
+      else {
+	cerr << "Output summary file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-clust2det" || string(argv[i]) == "-c2d" || string(argv[i]) == "-clust2detfile" || string(argv[i]) == "--clust2detfile" || string(argv[i]) == "--clust2det" || string(argv[i]) == "--cluster_to_detection") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	clust2detfile=argv[++i];
+	default_clust2detfile = 0;
+	i++;
+      }
+      else {
+	cerr << "Output cluster-to-detection file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose" || string(argv[i]) == "--VERBOSE" || string(argv[i]) == "--VERB") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	config.verbose=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Verbosity keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-statein" || string(argv[i]) == "-instate" || string(argv[i]) == "-oldstate" || string(argv[i]) == "--statein") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	stateinprefix=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Input stream state keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-stateout" || string(argv[i]) == "-outstate" || string(argv[i]) == "-newstate" || string(argv[i]) == "--stateout") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	stateoutprefix=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Output stream state keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-window" || string(argv[i]) == "-windowdays" || string(argv[i]) == "-window_days" || string(argv[i]) == "--window") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	windowdays=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Window length keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-rebase" || string(argv[i]) == "-rebasedays" || string(argv[i]) == "--rebase") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	rebasedays=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Rebase interval keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else {
+      cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
+      i++;
+    }
+  }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+  if(config.minobsnights > config.dbscan_npt) config.minobsnights = config.dbscan_npt; // Otherwise the low setting of dbscan_npt is not operative.
+
+  if(argc<15)
+    {
+      cerr << "Too few arguments even for minimalist invocation:\n";
+      show_usage();
+      return(1);
+    }
+  
+  cout.precision(17);  
+  cout << "input image file for new night " << imfile << "\n";
+  cout << "input detection file for new night " << pairdetfile << "\n";
+  cout << "input tracklet file for new night " << trackletfile << "\n";
+  cout << "input trk2det file for new night " << trk2detfile << "\n";
+  cout << "input observer position file " << planetfile << "\n";
+  cout << "input heliocentric hypothesis file " << accelfile << "\n";
+  if(stateinprefix.size()>0) cout << "input stream state prefix " << stateinprefix << "\n";
+  else cout << "No input stream state: starting a new stream\n";
+  cout << "output stream state prefix " << stateoutprefix << "\n";
+  cout << "window length " << windowdays << " days, maximum drift of reference MJD " << rebasedays << " days\n";
+
+  // Catch required parameters if missing
+  if(imfile.size()<=0) {
+    cout << "\nERROR: input image file is required\n";
+    show_usage();
+    return(1);
+  } else if(pairdetfile.size()<=0) {
+    cout << "\nERROR: input detection file is required\n";
+    show_usage();
+    return(1);
+  } else if(trackletfile.size()<=0) {
+    cout << "\nERROR: input tracklet file is required\n";
+    show_usage();
+    return(1);
+  } else if(trk2detfile.size()<=0) {
+    cout << "\nERROR: input trk2det file is required\n";
+    show_usage();
+    return(1);
+  } else if(stateoutprefix.size()<=0) {
+    cout << "\nERROR: output stream state prefix is required\n";
+    show_usage();
+    return(1);
+  } else if(planetfile.size()<=0) {
+    cout << "\nERROR: input observer position file is required:\n";
+    cout << "e.g. Earth1day2020s_02a.txt\n";
+    show_usage();
+    return(1);
+  } else if(accelfile.size()<=0) {
+    cout << "\nERROR: input heliocentric hypothesis file is required\n";
+    show_usage();
+    return(1);
+  } else if(windowdays<=0.0l) {
+    cout << "\nERROR: window length must be positive\n";
+    show_usage();
+    return(1);
+  }
+
+  // Catch case where max v_inf > 0 but universal variables are not set.
+  if(config.max_v_inf>0.0l && config.use_univar<=0) {
+    cerr << "ERROR: unbound orbits being probed (max_v_inf = " << config.max_v_inf << "),\n";
+    cerr << "but code is not set to use universal variables (use_univar = " << config.use_univar << ".\n";
+    show_usage();
+    return(1);
+  }
+
+  if(default_clustrad==1) cout << "Defaulting to cluster radius = " << config.clustrad << "km\n";
+  else cout << "input clustering radius " << config.clustrad << "km\n";
+  if(default_clustchangerad==1) cout << "Defaulting to min. geocentric distance for cluster scaling = " << config.clustchangerad << "AU\n";
+  else cout << "Min. geocentric distance for cluster scaling is " << config.clustchangerad << "AU\n";
+  cout << "Minimum cluster radius, which will apply for all geocentric distances less\n";
+  cout << "than " << config.clustchangerad << "AU, is " << config.clustrad*config.clustchangerad/REF_GEODIST << "km\n";
+  if(default_npt==1) cout << "Defaulting to DBSCAN npt (min. no. of tracklets in a linkage) = " << config.dbscan_npt << "\n";
+  else cout << "input DBSCAN npt (min. no. of tracklets in a linkage) is " << config.dbscan_npt << "\n";
+  if(default_minobsnights==1) cout << "Defaulting to minimum number of unique nights = " << config.minobsnights << "\n";
+  else cout << "minimum number of unique nights is " << config.minobsnights << "\n";
+  if(default_mintimespan==1) cout << "Defaulting to minimum time span for a linkage = " << config.mintimespan << " days\n";
+  else cout << "minimum time span for a linkage is " << config.mintimespan << " days\n";
+  if(default_mingeodist==1) cout << "Defaulting to minimum geocentric distance = " << config.mingeodist << " AU\n";
+  else cout << "minimum geocentric distance is " << config.mingeodist << " AU\n";
+  if(default_maxgeodist==1) cout << "Defaulting to maximum geocentric distance = " << config.maxgeodist << " AU\n";
+  else cout << "maximum geocentric distance is " << config.maxgeodist << " AU\n";
+  if(default_geologstep==1) cout << "Defaulting to logarithmic step size for geocentric distance bins = " << config.geologstep << "\n";
+  else cout << "logarithmic step size for geocentric distance bins is " << config.geologstep << "\n";
+  if(default_mingeoobs==1) cout << "Defaulting to minimum geocentric distance at observation = " << config.mingeoobs << " AU\n";
+  else cout << "Minimum geocentric distance at observation = " << config.mingeoobs << " AU\n";
+  if(default_minimpactpar==1) cout << "Defaulting to minimum impact parameter = " << config.minimpactpar << " km\n";
+  else cout << "Minimum impact parameter is " << config.minimpactpar << " km\n";
+  if(default_use_univar==1) cout << "For Keplerian integration, defaulting to f and g functions\nrather than universal variables\n";
+  else if(config.use_univar>0) cout << "Using universal variables for Keplerian integration\n";
+  else cout << "Using f and g functions for Keplerian integration\n";
+  if(default_max_v_inf==1) cout << "Defaulting to maximum v_inf relative to the sun = " << config.max_v_inf << " km/sec\n";
+  else cout << "Maximum v_inf relative to the sun is " << config.max_v_inf << " km\n";
+  if(config.prescreen==1) cout << "Coarse pre-screening of state vectors will be performed before clustering\n";
+  else if(config.prescreen==2) cout << "Coarse pre-screening will be validated against an exhaustive search\n";
+  if(default_sumfile==1) cout << "WARNING: using default name " << sumfile << " for summary output file\n";
+  else cout << "summary output file " << sumfile << "\n";
+  if(default_clust2detfile==1) cout << "WARNING: using default name " << clust2detfile << " for output clust2det file\n";
+  else cout << "output clust2det file " << clust2detfile << "\n";
+
+  cout << "Heliocentric ephemeris for Earth is named " << planetfile << "\n";
+  status = read_horizons_csv(planetfile, earthpos);
+  if(status!=0) {
+    cerr << "ERROR: could not successfully Earth ephemeris file " << planetfile << "\n";
+    cerr << "read_horizons_csv returned status = " << status << ".\n";
+   return(1);
+  } 
+
+  cout << "File with heliocentric motion hypothesis is named " << accelfile << "\n";
+  status=read_radhyp_file(accelfile, radhyp, config.verbose);
+  if(status!=0) {
+    cerr << "ERROR: could not successfully read accleration file " << accelfile << "\n";
+    cerr << "read_radhyp_file returned status = " << status << ".\n";
+   return(1);
+  }
+  
+  // Read the new night
+  status=read_pairdet_file(pairdetfile, newdets, config.verbose);
+  if(status!=0) {
+    cerr << "ERROR: could not successfully read paired detection file " << pairdetfile << "\n";
+    cerr << "read_pairdet_file returned status = " << status << ".\n";
+   return(1);
+  }
+  cout << "Read " << newdets.size() << " data lines from paired detection file " << pairdetfile << "\n";
+  status=read_image_file2(imfile, newimages);
+  if(status!=0) {
+    cerr << "ERROR: could not successfully read image file " << imfile << "\n";
+    cerr << "read_image_file2 returned status = " << status << ".\n";
+   return(1);
+  }
+  cout << "Read " << newimages.size() << " data lines from image file " << imfile << "\n";
+  if(newimages.size()<=0) {
+    cerr << "ERROR: no images for the new night\n";
+    return(1);
+  }
+  status=read_tracklet_file(trackletfile, newtracklets, config.verbose);
+  if(status!=0) {
+    cerr << "ERROR: could not successfully read tracklet file " << trackletfile << "\n";
+    cerr << "read_tracklet_file returned status = " << status << ".\n";
+   return(1);
+  }
+  cout << "Read " << newtracklets.size() << " data lines from tracklet file " << trackletfile << "\n";
+  status=read_longpair_file(trk2detfile, newtrk2det, config.verbose);
+  if(status!=0) {
+    cerr << "ERROR: could not successfully read trk2det file " << trk2detfile << "\n";
+    cerr << "read_longpair_file returned status = " << status << ".\n";
+   return(1);
+  }
+  cout << "Read " << newtrk2det.size() << " data lines from trk2det file " << trk2detfile << "\n";
+
+  // Read the stream state from the previous night, if any
+  if(stateinprefix.size()>0) {
+    status=read_image_file2(stateinprefix + "_images.txt", oldimages);
+    if(status==0) status=read_pairdet_file(stateinprefix + "_pairdets.csv", olddets, config.verbose);
+    if(status==0) status=read_tracklet_file(stateinprefix + "_tracklets.csv", oldtracklets, config.verbose);
+    if(status==0) status=read_longpair_file(stateinprefix + "_trk2det.csv", oldtrk2det, config.verbose);
+    if(status==0) status=read_streamstate_file(stateinprefix + "_statevecs.csv", MJDref, chartimescale, statehypnum, hypstate, config.verbose);
+    if(status!=0) {
+      cerr << "ERROR: could not successfully read stream state with prefix " << stateinprefix << "\n";
+      return(1);
+    }
+    cout << "Read stream state with " << oldimages.size() << " images, " << olddets.size() << " detections, and " << oldtracklets.size() << " tracklets\n";
+    cout << "Persisted reference MJD is " << MJDref << "\n";
+    if(statehypnum != long(radhyp.size())) {
+      cout << "WARNING: stream state has " << statehypnum << " hypotheses, but " << radhyp.size() << " were supplied.\n";
+      cout << "All state vectors will be recalculated\n";
+      recompute=1;
+    }
+  } else recompute=1;
+  if(recompute) hypstate = vector <vector <point6ix2>> (radhyp.size());
+
+  // Expire the oldest data and append the new night.
+  maxMJD = newimages[0].MJD;
+  for(i=0; i<long(newimages.size()); i++) {
+    if(maxMJD < newimages[i].MJD) maxMJD = newimages[i].MJD;
+  }
+  cutoffMJD = maxMJD - windowdays;
+  status = heliolinc_stream_window(oldimages, olddets, oldtracklets, oldtrk2det, newimages, newdets, newtracklets, newtrk2det, cutoffMJD, image_log, detvec, tracklets, trk2det, hypstate, firstnew);
+  if(status!=0) {
+    cerr << "ERROR: heliolinc_stream_window failed with status " << status << "\n";
+    return(status);
+  }
+  if(stateinprefix.size()<=0) firstnew=0; // First night: everything is new.
+
+  // Check whether the reference MJD needs to be reset.
+  minMJD = maxMJD = image_log[0].MJD;
+  for(i=0; i<long(image_log.size()); i++) {
+    if(minMJD > image_log[i].MJD) minMJD = image_log[i].MJD;
+    if(maxMJD < image_log[i].MJD) maxMJD = image_log[i].MJD;
+  }
+  centerMJD = minMJD*0.5l + maxMJD*0.5l;
+  if(!recompute && fabs(centerMJD - MJDref) > rebasedays) {
+    cout << "Window center MJD " << centerMJD << " has drifted more than " << rebasedays << " days from the reference MJD " << MJDref << "\n";
+    cout << "All state vectors will be recalculated\n";
+    recompute=1;
+  }
+  if(recompute) {
+    MJDref = round(centerMJD*100.0l)/100.0l;
+    chartimescale = windowdays*SOLARDAY/TIMECONVSCALE; // Note that the units are seconds.
+    hypstate = vector <vector <point6ix2>> (radhyp.size());
+    firstcompute = 0;
+    cout << fixed << setprecision(2) << "Adopting reference MJD = " << MJDref << "\n";
+  } else firstcompute = firstnew;
+  config.MJDref = MJDref;
+
+  status=heliolinc_alg_stream(image_log, detvec, tracklets, trk2det, firstcompute, firstnew, radhyp, earthpos, config, chartimescale, hypstate, outclust, clust2det);
+  if(status!=0) {
+    cerr << "ERROR: heliolinc_alg_stream failed with status " << status << "\n";
+    return(status);
+  } 
+  
+  outstream1.open(sumfile);
+  cout << "Writing " << outclust.size() << " lines to output cluster-summary file " << sumfile << "\n";
+  outstream1 << "#clusternum,posRMS,velRMS,totRMS,astromRMS,pairnum,timespan,uniquepoints,obsnights,metric,rating,reference_MJD,heliohyp0,heliohyp1,heliohyp2,posX,posY,posZ,velX,velY,velZ,orbit_a,orbit_e,orbit_incl,orbit_MJD,orbitX,orbitY,orbitZ,orbitVX,orbitVY,orbitVZ,orbit_eval_count\n";
+  for(clustct=0 ; clustct<long(outclust.size()); clustct++) {
+    outstream1 << fixed << setprecision(3) << outclust[clustct].clusternum << "," << outclust[clustct].posRMS << "," << outclust[clustct].velRMS << "," << outclust[clustct].totRMS << ",";
+    outstream1 << fixed << setprecision(4) << outclust[clustct].astromRMS << ",";
+    outstream1 << fixed << setprecision(6) << outclust[clustct].pairnum << "," << outclust[clustct].timespan << "," << outclust[clustct].uniquepoints << "," << outclust[clustct].obsnights << "," << outclust[clustct].metric << "," << outclust[clustct].rating << ",";
+    outstream1 << fixed << setprecision(6) << outclust[clustct].reference_MJD << "," << outclust[clustct].heliohyp0 << "," << outclust[clustct].heliohyp1 << "," << outclust[clustct].heliohyp2 << ",";
+    outstream1 << fixed << setprecision(1) << outclust[clustct].posX << "," << outclust[clustct].posY << "," << outclust[clustct].posZ << ",";
+    outstream1 << fixed << setprecision(4) << outclust[clustct].velX << "," << outclust[clustct].velY << "," << outclust[clustct].velZ << ",";
+    outstream1 << fixed << setprecision(6) << outclust[clustct].orbit_a << "," << outclust[clustct].orbit_e << "," << outclust[clustct].orbit_incl << "," << outclust[clustct].orbit_MJD << ",";
+    outstream1 << fixed << setprecision(1) << outclust[clustct].orbitX << "," << outclust[clustct].orbitY << "," << outclust[clustct].orbitZ << ",";
+    outstream1 << fixed << setprecision(4) << outclust[clustct].orbitVX << "," << outclust[clustct].orbitVY << "," << outclust[clustct].orbitVZ << "," << outclust[clustct].orbit_eval_count << "\n";
+  }
+  outstream1.close();
+  outstream1.open(clust2detfile);
+  cout << "Writing " << clust2det.size() << " lines to output clust2det file " << clust2detfile << "\n";
+  outstream1 << "#clusternum,detnum\n";
+  for(clustct=0 ; clustct<long(clust2det.size()); clustct++) {
+    outstream1 << clust2det[clustct].i1 << "," << clust2det[clustct].i2 << "\n";
+  }
+  outstream1.close();
+  
+  // Write the new stream state
+  string stateimfile = stateoutprefix + "_images.txt";
+  cout << "Writing stream state image file " << stateimfile << " with " << image_log.size() << " lines\n";
+  outstream1.open(stateimfile);
+  for(i=0; i<long(image_log.size()); i++) {
+    outstream1 << fixed << setprecision(8) << image_log[i].MJD << " " << image_log[i].RA;
+    outstream1 << fixed << setprecision(8) << " " << image_log[i].Dec << " " << image_log[i].obscode << " ";
+    outstream1 << fixed << setprecision(1) << image_log[i].X << " " << image_log[i].Y << " " << image_log[i].Z << " ";
+    outstream1 << fixed << setprecision(4) << image_log[i].VX << " " << image_log[i].VY << " " << image_log[i].VZ << " ";
+    outstream1 << image_log[i].startind << " " << image_log[i].endind << " " << image_log[i].exptime << "\n";
+  }
+  outstream1.close();
+  string statedetfile = stateoutprefix + "_pairdets.csv";
+  cout << "Writing stream state paired detection file " << statedetfile << " with " << detvec.size() << " lines\n";
+  outstream1.open(statedetfile);
+  outstream1 << "#MJD,RA,Dec,mag,trail_len,trail_PA,sigmag,sig_across,sig_along,image,idstring,band,obscode,known_obj,det_qual,origindex\n";
+  for(i=0; i<long(detvec.size()); i++) {
+    outstream1 << fixed << setprecision(7) << detvec[i].MJD << "," << detvec[i].RA << "," << detvec[i].Dec << ",";
+    outstream1 << fixed << setprecision(4) << detvec[i].mag << ",";
+    outstream1 << fixed << setprecision(2) << detvec[i].trail_len << "," << detvec[i].trail_PA << ",";
+    outstream1 << fixed << setprecision(4) << detvec[i].sigmag << ",";
+    outstream1 << fixed << setprecision(3) << detvec[i].sig_across << "," << detvec[i].sig_along << ",";
+    outstream1 << detvec[i].image << "," << detvec[i].idstring << "," << detvec[i].band << ",";
+    outstream1 << detvec[i].obscode << "," << detvec[i].known_obj << ","; 
+    outstream1 << detvec[i].det_qual << "," << detvec[i].index << "\n"; 
+  }
+  outstream1.close();
+  string statetrkfile = stateoutprefix + "_tracklets.csv";
+  cout << "Writing stream state tracklet file " << statetrkfile << " with " << tracklets.size() << " lines\n";
+  outstream1.open(statetrkfile);
+  outstream1 << "#Image1,RA1,Dec1,Image2,RA2,Dec2,npts,trk_ID\n";
+  for(i=0; i<long(tracklets.size()); i++) {
+    outstream1 << fixed << setprecision(7) << tracklets[i].Img1 << "," << tracklets[i].RA1 << "," << tracklets[i].Dec1 << ",";
+    outstream1 << fixed << setprecision(7) << tracklets[i].Img2 << "," << tracklets[i].RA2 << "," << tracklets[i].Dec2 << ",";
+    outstream1 << tracklets[i].npts << "," << tracklets[i].trk_ID << "\n"; 
+  }
+  outstream1.close();
+  string statet2dfile = stateoutprefix + "_trk2det.csv";
+  cout << "Writing stream state trk2det file " << statet2dfile << " with " << trk2det.size() << " lines\n";
+  outstream1.open(statet2dfile);
+  outstream1 << "#trk_ID,detnum\n";
+  for(i=0; i<long(trk2det.size()); i++) {
+    outstream1 << trk2det[i].i1 << "," << trk2det[i].i2 << "\n"; 
+  }
+  outstream1.close();
+  string statesvfile = stateoutprefix + "_statevecs.csv";
+  cout << "Writing stream state vector file " << statesvfile << "\n";
+  status = write_streamstate_file(statesvfile, MJDref, chartimescale, hypstate);
+  if(status!=0) {
+    cerr << "ERROR: could not write stream state vector file " << statesvfile << "\n";
+    return(status);
+  }
+  
+  if(profilefile.size()>0) hlprof_write(profilefile, "heliolinc_stream");
+  return(0);
+}
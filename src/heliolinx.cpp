@@ -8,9 +8,28 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl_bind.h>
+#include <pybind11/functional.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <set>
+#include <exception>
 
 namespace py = pybind11;
 
+// October 18, 2026: vectors of the input and output record types are
+// bound as opaque, C++-owned Python classes (see bind_vector in the
+// module definition below), rather than being converted to and from
+// Python lists.
+PYBIND11_MAKE_OPAQUE(std::vector<hldet>);
+PYBIND11_MAKE_OPAQUE(std::vector<hlimage>);
+PYBIND11_MAKE_OPAQUE(std::vector<tracklet>);
+PYBIND11_MAKE_OPAQUE(std::vector<longpair>);
+PYBIND11_MAKE_OPAQUE(std::vector<hlradhyp>);
+PYBIND11_MAKE_OPAQUE(std::vector<EarthState>);
+PYBIND11_MAKE_OPAQUE(std::vector<hlclust>);
+
 void fill_struct(hldet & out, hldet const& in) {
     out.MJD = in.MJD;
     out.RA = in.RA;
@@ -51,6 +70,8 @@ void fill_struct(hlimage & out, hlimage const& in) {
     out.VX = in.VX;
     out.VY = in.VY;
     out.VZ = in.VZ;
+    out.startind = in.startind;
+    out.endind = in.endind;
     out.exptime = in.exptime;
 }
 
@@ -133,14 +154,33 @@ void fill_struct(point3d_index & out, point3d_index const& in) {
     out.index  = in.index;
 }; 
 
+void fill_struct(observatory & out, observatory const& in) {
+    memcpy(out.obscode, in.obscode, sizeof(in.obscode));
+    out.obslon = in.obslon;
+    out.plxcos = in.plxcos;
+    out.plxsin = in.plxsin;
+}
+
 
+// ndarray_to_vec and vec_to_ndarray: modified October 18, 2026:
+// Every dtype used here is registered with PYBIND11_NUMPY_DTYPE,
+// so the numpy record layout is identical to that of the C++
+// class, and a contiguous input array can be loaded with a single
+// bulk copy rather than one fill_struct call per element. The
+// element-by-element path is kept for strided inputs (e.g., slices).
 template<typename T>
 std::vector<T> ndarray_to_vec(py::array_t<T> py_vec) {
     py::dtype expected_dtype = py::dtype::of<T>();
     if (!py_vec.dtype().is(expected_dtype)) {
 	throw std::runtime_error("Array dtype does not match expected type 'foo'. See mjuric@astro.washington.edu for more details");
     }
+    if (py_vec.ndim() == 1 && py_vec.itemsize() == (py::ssize_t) sizeof(T) && (py_vec.size() <= 1 || py_vec.strides(0) == (py::ssize_t) sizeof(T))) {
+        // Contiguous buffer: copy it in one pass.
+        const T *data_in = py_vec.data();
+        return std::vector<T>(data_in, data_in + py_vec.size());
+    }
     std::vector<T> vec = {};
+    vec.reserve(py_vec.size());
 
     // Get a reference to the py_array data
     auto data_ref = py_vec.unchecked();
@@ -158,22 +198,23 @@ std::vector<T> ndarray_to_vec(py::array_t<T> py_vec) {
     return vec;
 }
 
+// Copying version, for vectors the caller still needs.
 template<typename T>
 py::array vec_to_ndarray(std::vector<T> const& vec) {
-    // Allocate a structured numpy array of type T
-    auto py_vec = py::array_t<T>(vec.size());
-
-    // Get a mutable reference to the ndarray data
-    auto data_ref = py_vec.mutable_unchecked();
-
-    // Place vector data into numpy array
-    for (long int i = 0; i < data_ref.size(); i++) {
-        auto data_in = vec[i];
-        auto &data_out = data_ref[i];
+    // Allocate a structured numpy array of type T, filled
+    // from the vector data in one bulk copy.
+    if (vec.size() == 0) return py::array_t<T>(0);
+    return py::array_t<T>(vec.size(), vec.data());
+}
 
-        fill_struct(data_out, data_in);
-    }
-    return py_vec;
+// Zero-copy version: the vector's storage is handed over to numpy,
+// which frees it (through the capsule) when the array is released.
+template<typename T>
+py::array vec_to_ndarray(std::vector<T>&& vec) {
+    if (vec.size() == 0) return py::array_t<T>(0);
+    std::vector<T> *heapvec = new std::vector<T>(std::move(vec));
+    py::capsule owner(heapvec, [](void *p) { delete reinterpret_cast<std::vector<T> *>(p); });
+    return py::array_t<T>(heapvec->size(), heapvec->data(), owner);
 }
 
 py::array iotest02(py::array_t<hldet> py_ioin)
@@ -272,6 +313,64 @@ py::array observer_vel(double detmjd, double lon, double obscos, double obssine,
   return(py_outvec);
 }
 
+// makeImageTable: October 18, 2026:
+// Construct the image table for a set of detections entirely in C++,
+// replacing the python make_image_table and image_add_observerpos,
+// which grew numpy arrays one row at a time and were quadratic in the
+// number of detections. The detections are time-sorted exactly as in
+// make_tracklets, the images are inferred from them by load_image_table,
+// and the observer's heliocentric position and velocity are calculated
+// for every image in the same pass. Returns the time-sorted detections
+// (whose order the image startind and endind values refer to) and
+// the image table.
+std::tuple<py::array, py::array> makeImageTable(
+    py::array_t<hldet> py_detvec,
+    py::array_t<observatory> py_obsarr,
+    py::array_t<EarthState> py_earthpos,
+    double time_offset
+  ) {
+  std::vector <hldet> detvec = ndarray_to_vec(py_detvec);
+  std::vector <observatory> observatory_list = ndarray_to_vec(py_obsarr);
+  std::vector <EarthState> earthpos = ndarray_to_vec(py_earthpos);
+  std::vector <hlimage> image_log;
+  std::vector <double> EarthMJD;
+  std::vector <point3d> Earthpos;
+  std::vector <point3d> Earthvel;
+  int status=0;
+  int sortstatus=0;
+
+  if(detvec.size()<=0) {
+    throw std::runtime_error("makeImageTable called with an empty detection array");
+  }
+  EarthMJD.reserve(earthpos.size());
+  Earthpos.reserve(earthpos.size());
+  Earthvel.reserve(earthpos.size());
+  for(long i=0; i<long(earthpos.size()); i++) {
+    EarthMJD.push_back(earthpos[i].MJD);
+    Earthpos.push_back(point3d(earthpos[i].x, earthpos[i].y, earthpos[i].z));
+    Earthvel.push_back(point3d(earthpos[i].vx, earthpos[i].vy, earthpos[i].vz));
+  }
+
+  {
+    // Release the GIL while the C++ code runs, so other Python threads can proceed.
+    py::gil_scoped_release release;
+    // time-sort the detection vector
+    sortstatus = sort_hldet_parallel(detvec, IMAGETIMETOL/SOLARDAY);
+    if(sortstatus==0) status = load_image_table(image_log, detvec, time_offset, observatory_list, EarthMJD, Earthpos, Earthvel);
+  }
+  if(sortstatus!=0) {
+    throw std::runtime_error("sort_hldet_parallel failed with status " + std::to_string(sortstatus));
+  }
+  if(status!=0) {
+    throw std::runtime_error("load_image_table failed with status " + std::to_string(status));
+  }
+
+  auto py_detout = vec_to_ndarray<hldet>(std::move(detvec));
+  auto py_imgout = vec_to_ndarray<hlimage>(std::move(image_log));
+
+  return(std::make_tuple(py_detout, py_imgout));
+}
+
 // makeTracklets: April 07, 2023:
 // Minimalist wrapper, only handles the python <-> C++ translations.
 // All the interesting algorithmic stuff happens in functions called from solarsyst_dyn_geo01.
@@ -289,13 +388,17 @@ std::tuple<py::array, py::array, py::array> makeTracklets(
   std::vector <tracklet> tracklets;
   std::vector <longpair> trk2det;  
   
-  make_tracklets7(detvec,image_log,config,pairdets,tracklets,trk2det);
+  {
+    // Release the GIL while the C++ code runs, so other Python threads can proceed.
+    py::gil_scoped_release release;
+    make_tracklets7(detvec,image_log,config,pairdets,tracklets,trk2det);
+  }
   
-  auto py_detout1 = vec_to_ndarray<hldet>(pairdets);
+  auto py_detout1 = vec_to_ndarray<hldet>(std::move(pairdets));
   cout << "loaded pairdets\n";
-  auto py_detout2 = vec_to_ndarray<tracklet>(tracklets);
+  auto py_detout2 = vec_to_ndarray<tracklet>(std::move(tracklets));
   cout << "loaded tracklets\n";
-  auto py_detout3 = vec_to_ndarray<longpair>(trk2det);
+  auto py_detout3 = vec_to_ndarray<longpair>(std::move(trk2det));
   cout << "loaded trk2det\n";
 
   return(std::make_tuple(py_detout1, py_detout2, py_detout3));
@@ -321,13 +424,16 @@ std::tuple<py::array, py::array, py::array> makeTrailedTracklets(
   // Note: make_trailed_tracklets2 is an advance over make_trailed_tracklets
   // in that it culls the ouput 'pairdets' array down to only those
   // detections (sources) that were actually included in a tracklet.
-  make_trailed_tracklets2(detvec,image_log,config,pairdets,tracklets,trk2det);
+  {
+    py::gil_scoped_release release;
+    make_trailed_tracklets2(detvec,image_log,config,pairdets,tracklets,trk2det);
+  }
   
-  auto py_detout1 = vec_to_ndarray<hldet>(pairdets);
+  auto py_detout1 = vec_to_ndarray<hldet>(std::move(pairdets));
   cout << "loaded pairdets\n";
-  auto py_detout2 = vec_to_ndarray<tracklet>(tracklets);
+  auto py_detout2 = vec_to_ndarray<tracklet>(std::move(tracklets));
   cout << "loaded tracklets\n";
-  auto py_detout3 = vec_to_ndarray<longpair>(trk2det);
+  auto py_detout3 = vec_to_ndarray<longpair>(std::move(trk2det));
   cout << "loaded trk2det\n";
 
   return(std::make_tuple(py_detout1, py_detout2, py_detout3));
@@ -358,15 +464,18 @@ std::tuple<py::array, py::array>heliolinc(
   std::vector <hlclust> outclust;
   std::vector <longpair> clust2det;
      
-  status = heliolinc_alg_lowmem(image_log, detvec, tracklets, trk2det, radhyp, earthpos, config, outclust, clust2det);
+  {
+    py::gil_scoped_release release;
+    status = heliolinc_alg_lowmem(image_log, detvec, tracklets, trk2det, radhyp, earthpos, config, outclust, clust2det);
+  }
   if(status!=0) {
     cerr << "ERROR: heliolinc returned failure status " << status << "\n";
     auto py_clustout = vec_to_ndarray<hlclust>({});
     return(std::make_tuple(py_clustout, py_clustout));
   }
       
-  auto py_detout1 = vec_to_ndarray<hlclust>(outclust);
-  auto py_detout2 = vec_to_ndarray<longpair>(clust2det);
+  auto py_detout1 = vec_to_ndarray<hlclust>(std::move(outclust));
+  auto py_detout2 = vec_to_ndarray<longpair>(std::move(clust2det));
 
   return(std::make_tuple(py_detout1, py_detout2));
 }
@@ -393,15 +502,18 @@ std::tuple<py::array, py::array>linkPurify(
   std::vector <hlclust> outclust;
   std::vector <longpair> outclust2det;
      
-  status = link_purify(image_log, detvec, inclust, inclust2det, config, outclust, outclust2det);
+  {
+    py::gil_scoped_release release;
+    status = link_purify(image_log, detvec, inclust, inclust2det, config, outclust, outclust2det);
+  }
   if(status!=0) {
     cerr << "ERROR: link_purify returned failure status " << status << "\n";
     auto py_clustout = vec_to_ndarray<hlclust>({});
     return(std::make_tuple(py_clustout, py_clustout));
   }
       
-  auto py_detout1 = vec_to_ndarray<hlclust>(outclust);
-  auto py_detout2 = vec_to_ndarray<longpair>(outclust2det);
+  auto py_detout1 = vec_to_ndarray<hlclust>(std::move(outclust));
+  auto py_detout2 = vec_to_ndarray<longpair>(std::move(outclust2det));
 
   return(std::make_tuple(py_detout1, py_detout2));
 }
@@ -427,20 +539,88 @@ std::tuple<py::array, py::array>linkPlanarity(
   std::vector <hlclust> outclust;
   std::vector <longpair> outclust2det;
      
-  status = link_planarity(image_log, detvec, inclust, inclust2det, config, outclust, outclust2det);
+  {
+    py::gil_scoped_release release;
+    status = link_planarity(image_log, detvec, inclust, inclust2det, config, outclust, outclust2det);
+  }
   if(status!=0) {
     cerr << "ERROR: link_planarity returned failure status " << status << "\n";
     auto py_clustout = vec_to_ndarray<hlclust>({});
     return(std::make_tuple(py_clustout, py_clustout));
   }
       
-  auto py_detout1 = vec_to_ndarray<hlclust>(outclust);
-  auto py_detout2 = vec_to_ndarray<longpair>(outclust2det);
+  auto py_detout1 = vec_to_ndarray<hlclust>(std::move(outclust));
+  auto py_detout2 = vec_to_ndarray<longpair>(std::move(outclust2det));
 
   return(std::make_tuple(py_detout1, py_detout2));
 }
 
 
+// heliolinc_vec, linkPurify_vec, linkPlanarity_vec: October 18, 2026:
+// Versions of the heliolinc, linkPurify, and linkPlanarity wrappers
+// that take and return the C++-owned vector classes (HldetVector etc.,
+// registered below with bind_vector) instead of numpy arrays. The
+// algorithms only read their inputs, so these are passed by reference
+// with no copy at all, and the outputs are moved, not copied, into new
+// vector objects. A numpy array is loaded into one of these classes
+// with a single bulk copy (e.g. heliolinx.HldetVector(detarray)), after
+// which the array can be deleted; np.asarray() on a vector object
+// gives a numpy view of its storage, again without a copy. Outputs of
+// heliolinc_vec can be passed straight to linkPurify_vec.
+std::tuple<std::vector <hlclust>, std::vector <longpair>> heliolinc_vec(HeliolincConfig config, const std::vector <hlimage> &image_log, const std::vector <hldet> &detvec, const std::vector <tracklet> &tracklets, const std::vector <longpair> &trk2det, const std::vector <hlradhyp> &radhyp, const std::vector <EarthState> &earthpos)
+{
+  cout << "C++ wrapper for heliolinc, on C++-owned vectors\n";
+  int status = 0;
+  std::vector <hlclust> outclust;
+  std::vector <longpair> clust2det;
+  {
+    py::gil_scoped_release release;
+    status = heliolinc_alg_lowmem(image_log, detvec, tracklets, trk2det, radhyp, earthpos, config, outclust, clust2det);
+  }
+  if(status!=0) {
+    cerr << "ERROR: heliolinc returned failure status " << status << "\n";
+    outclust={};
+    clust2det={};
+  }
+  return(std::make_tuple(std::move(outclust), std::move(clust2det)));
+}
+
+std::tuple<std::vector <hlclust>, std::vector <longpair>> linkPurify_vec(LinkPurifyConfig config, const std::vector <hlimage> &image_log, const std::vector <hldet> &detvec, const std::vector <hlclust> &inclust, const std::vector <longpair> &inclust2det)
+{
+  cout << "C++ wrapper for link_refine_Herget, on C++-owned vectors\n";
+  int status = 0;
+  std::vector <hlclust> outclust;
+  std::vector <longpair> outclust2det;
+  {
+    py::gil_scoped_release release;
+    status = link_purify(image_log, detvec, inclust, inclust2det, config, outclust, outclust2det);
+  }
+  if(status!=0) {
+    cerr << "ERROR: link_purify returned failure status " << status << "\n";
+    outclust={};
+    outclust2det={};
+  }
+  return(std::make_tuple(std::move(outclust), std::move(outclust2det)));
+}
+
+std::tuple<std::vector <hlclust>, std::vector <longpair>> linkPlanarity_vec(LinkPurifyConfig config, const std::vector <hlimage> &image_log, const std::vector <hldet> &detvec, const std::vector <hlclust> &inclust, const std::vector <longpair> &inclust2det)
+{
+  cout << "C++ wrapper for link_planarity, on C++-owned vectors\n";
+  int status = 0;
+  std::vector <hlclust> outclust;
+  std::vector <longpair> outclust2det;
+  {
+    py::gil_scoped_release release;
+    status = link_planarity(image_log, detvec, inclust, inclust2det, config, outclust, outclust2det);
+  }
+  if(status!=0) {
+    cerr << "ERROR: link_planarity returned failure status " << status << "\n";
+    outclust={};
+    outclust2det={};
+  }
+  return(std::make_tuple(std::move(outclust), std::move(outclust2det)));
+}
+
 // findGlints: July 17, 2024:
 // Minimalist wrapper, only handles the python <-> C++ translations.
 // All the interesting algorithmic stuff happens in functions called from solarsyst_dyn_geo01.
@@ -457,15 +637,18 @@ std::tuple<py::array, py::array>findGlints(
   std::vector <glint_trail> trailvec;
   std::vector <longpair> trail2det;
      
-  status = find_glints_xypix(detvec, config, trailvec, trail2det);
+  {
+    py::gil_scoped_release release;
+    status = find_glints_xypix(detvec, config, trailvec, trail2det);
+  }
   if(status!=0) {
     cerr << "ERROR: find_glints_xypix returned failure status " << status << "\n";
     auto py_empty = vec_to_ndarray<point3d_index>({});
     return(std::make_tuple(py_empty, py_empty));
   }
       
-  auto py_detout1 = vec_to_ndarray<glint_trail>(trailvec);
-  auto py_detout2 = vec_to_ndarray<longpair>(trail2det);
+  auto py_detout1 = vec_to_ndarray<glint_trail>(std::move(trailvec));
+  auto py_detout2 = vec_to_ndarray<longpair>(std::move(trail2det));
 
   return(std::make_tuple(py_detout1, py_detout2));
 }
@@ -486,20 +669,255 @@ std::tuple<py::array, py::array>findGlintsRadec(
   std::vector <glint_trail> trailvec;
   std::vector <longpair> trail2det;
      
-  status = find_glints_radec(detvec, config, trailvec, trail2det);
+  {
+    py::gil_scoped_release release;
+    status = find_glints_radec(detvec, config, trailvec, trail2det);
+  }
   if(status!=0) {
     cerr << "ERROR: find_glints_radec returned failure status " << status << "\n";
     auto py_empty = vec_to_ndarray<point3d_index>({});
     return(std::make_tuple(py_empty, py_empty));
   }
       
-  auto py_detout1 = vec_to_ndarray<glint_trail>(trailvec);
-  auto py_detout2 = vec_to_ndarray<longpair>(trail2det);
+  auto py_detout1 = vec_to_ndarray<glint_trail>(std::move(trailvec));
+  auto py_detout2 = vec_to_ndarray<longpair>(std::move(trail2det));
 
   return(std::make_tuple(py_detout1, py_detout2));
 }
 
 
+// findGlintsCatalog: October 18, 2026:
+// Minimalist wrapper, only handles the python <-> C++ translations.
+// Runs the glint search over every image of a catalog in parallel.
+// use_xypix selects the pixel x,y version (1) or the RA, Dec version (0).
+std::tuple<py::array, py::array>findGlintsCatalog(
+    FindGlintsConfig config,
+    py::array_t<point3d_index> py_sourcecat,
+    py::array_t<hlimage> py_imglog,
+    int use_xypix
+  ) {
+  cout << "C++ wrapper for find_glints_catalog\n";
+  
+  std::vector <point3d_index> detvec = ndarray_to_vec(py_sourcecat);
+  std::vector <hlimage> image_log = ndarray_to_vec(py_imglog);
+  int status = 0;
+  std::vector <glint_trail> trailvec;
+  std::vector <longpair> trail2det;
+     
+  {
+    py::gil_scoped_release release;
+    status = find_glints_catalog(detvec, image_log, config, use_xypix, trailvec, trail2det, 0);
+  }
+  if(status!=0) {
+    cerr << "ERROR: find_glints_catalog returned failure status " << status << "\n";
+    auto py_empty = vec_to_ndarray<point3d_index>({});
+    return(std::make_tuple(py_empty, py_empty));
+  }
+      
+  auto py_detout1 = vec_to_ndarray<glint_trail>(std::move(trailvec));
+  auto py_detout2 = vec_to_ndarray<longpair>(std::move(trail2det));
+
+  return(std::make_tuple(py_detout1, py_detout2));
+}
+
+// HeliolincStream: October 18, 2026:
+// Streaming version of the heliolinc wrapper. A C++ producer thread
+// runs heliolinc_alg_lowmem on successive batches of hyp_per_batch
+// hypotheses and pushes each batch's de-duplicated linkages onto a
+// bounded queue (at most maxqueue batches), from which Python pulls
+// them as an iterator. The producer blocks when the queue is full, so
+// memory stays bounded however slowly the Python side consumes, and
+// the GIL is released whenever C++ is working or waiting. Linkages are
+// de-duplicated by heliolinc_alg_lowmem within each batch; across
+// batches, exact repeats of a set of detections already yielded within
+// the last dedup_hyps hypotheses are dropped. Only those recent sets are
+// kept, so the memory for de-duplication stays bounded too: the same
+// object is normally found only by neighbouring hypotheses, so the
+// window should span at least one step of the slowest-varying
+// hypothesis parameter. The configuration is echoed for the first
+// batch only. Cluster numbers (hlclust.clusternum and clust2det.i1)
+// run continuously across all batches. A failure status or an exception
+// in the producer ends the stream, and is raised by the next call to
+// next() once the batches already queued have been yielded.
+class HeliolincStream {
+public:
+  HeliolincStream(HeliolincConfig config, py::array_t<hlimage> py_imglog, py::array_t<hldet> py_detvec, py::array_t<tracklet> py_tracklets, py::array_t<longpair> py_trk2det, py::array_t<hlradhyp> py_radhyp, py::array_t<EarthState> earthin, long hyp_per_batch, long maxqueue, long dedup_hyps)
+    : config(config), hyp_per_batch(hyp_per_batch>0 ? hyp_per_batch : 1), maxqueue(maxqueue>0 ? maxqueue : 1), dedup_hyps(dedup_hyps>0 ? dedup_hyps : 0)
+  {
+    image_log = ndarray_to_vec(py_imglog);
+    detvec = ndarray_to_vec(py_detvec);
+    tracklets = ndarray_to_vec(py_tracklets);
+    trk2det = ndarray_to_vec(py_trk2det);
+    radhyp = ndarray_to_vec(py_radhyp);
+    earthpos = ndarray_to_vec(earthin);
+    producer = std::thread(&HeliolincStream::produce, this);
+  }
+
+  ~HeliolincStream() {
+    py::gil_scoped_release release;
+    close();
+  }
+
+  // Stop the producer after the batch it is working on, and wait for it.
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(qmutex);
+      stopflag = true;
+    }
+    notfull.notify_all();
+    if(producer.joinable()) producer.join();
+  }
+
+  std::tuple<py::array, py::array> next() {
+    std::vector <hlclust> outclust;
+    std::vector <longpair> clust2det;
+    bool finished = false;
+    {
+      py::gil_scoped_release release;
+      std::unique_lock<std::mutex> lock(qmutex);
+      notempty.wait(lock, [this]{ return(!batches.empty() || done); });
+      if(batches.empty()) finished = true;
+      else {
+	outclust = std::move(batches.front().first);
+	clust2det = std::move(batches.front().second);
+	batches.pop_front();
+      }
+    }
+    if(finished) {
+      if(error) std::rethrow_exception(error);
+      if(status!=0) throw std::runtime_error("heliolinc failed with status " + std::to_string(status));
+      throw py::stop_iteration();
+    }
+    notfull.notify_one();
+    auto py_clustout = vec_to_ndarray<hlclust>(std::move(outclust));
+    auto py_clust2det = vec_to_ndarray<longpair>(std::move(clust2det));
+    return(std::make_tuple(py_clustout, py_clust2det));
+  }
+
+private:
+  // Producer thread: run the batches, and always mark the stream done,
+  // so that next() cannot wait forever. An exception cannot propagate
+  // out of a std::thread (it would call std::terminate), so it is
+  // stored for next() to rethrow.
+  void produce() {
+    try {
+      produce_batches();
+    } catch(...) {
+      std::lock_guard<std::mutex> lock(qmutex);
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(qmutex);
+      done = true;
+    }
+    notempty.notify_all();
+  }
+
+  void produce_batches() {
+    long hypnum = radhyp.size();
+    long clustoffset = 0;
+    HeliolincConfig batchconfig = config;
+    // Detection sets yielded by recent batches, each labeled with
+    // the end of its batch's hypothesis range.
+    std::deque <std::pair <long, std::set <std::vector <long>>>> emitted;
+    for(long hypstart=0; hypstart<hypnum; hypstart+=hyp_per_batch) {
+      {
+	std::unique_lock<std::mutex> lock(qmutex);
+	notfull.wait(lock, [this]{ return(long(batches.size())<maxqueue || stopflag); });
+	if(stopflag) break;
+      }
+      long hypend = hypstart+hyp_per_batch;
+      if(hypend>hypnum) hypend=hypnum;
+      std::vector <hlradhyp> batchhyp(radhyp.begin()+hypstart, radhyp.begin()+hypend);
+      std::vector <hlclust> batchclust, outclust;
+      std::vector <longpair> batch2det, clust2det;
+      int batchstatus = heliolinc_alg_lowmem(image_log, detvec, tracklets, trk2det, batchhyp, earthpos, batchconfig, batchclust, batch2det);
+      batchconfig.echo_config = 0;
+      if(batchstatus!=0) {
+	cerr << "ERROR: heliolinc returned failure status " << batchstatus << " for hypotheses " << hypstart << "-" << hypend-1 << "\n";
+	std::lock_guard<std::mutex> lock(qmutex);
+	status = batchstatus;
+	break;
+      }
+      // Forget linkages from batches that have left the window, drop
+      // those already yielded by a batch within it, and renumber the
+      // rest to continue from the previous batches.
+      while(!emitted.empty() && emitted.front().first <= hypstart-dedup_hyps) emitted.pop_front();
+      emitted.push_back(std::make_pair(hypend, std::set <std::vector <long>>()));
+      long c2dct=0;
+      for(long clusterct=0; clusterct<long(batchclust.size()); clusterct++) {
+	std::vector <long> clustdets;
+	while(c2dct<long(batch2det.size()) && batch2det[c2dct].i1<batchclust[clusterct].clusternum) c2dct++;
+	while(c2dct<long(batch2det.size()) && batch2det[c2dct].i1==batchclust[clusterct].clusternum) clustdets.push_back(batch2det[c2dct++].i2);
+	std::sort(clustdets.begin(), clustdets.end());
+	bool repeat = false;
+	for(long i=0; i<long(emitted.size())-1 && !repeat; i++) repeat = emitted[i].second.count(clustdets)>0;
+	if(repeat || !emitted.back().second.insert(clustdets).second) continue;
+	long newclust = clustoffset + long(outclust.size());
+	for(long i=0; i<long(clustdets.size()); i++) clust2det.push_back(longpair(newclust, clustdets[i]));
+	outclust.push_back(batchclust[clusterct]);
+	outclust.back().clusternum = newclust;
+      }
+      clustoffset += outclust.size();
+      {
+	std::lock_guard<std::mutex> lock(qmutex);
+	batches.push_back(std::make_pair(std::move(outclust), std::move(clust2det)));
+      }
+      notempty.notify_one();
+    }
+  }
+
+  HeliolincConfig config;
+  long hyp_per_batch;
+  long maxqueue;
+  long dedup_hyps;
+  std::vector <hlimage> image_log;
+  std::vector <hldet> detvec;
+  std::vector <tracklet> tracklets;
+  std::vector <longpair> trk2det;
+  std::vector <hlradhyp> radhyp;
+  std::vector <EarthState> earthpos;
+  std::deque <std::pair <std::vector <hlclust>, std::vector <longpair>>> batches;
+  std::mutex qmutex;
+  std::condition_variable notempty;
+  std::condition_variable notfull;
+  bool done = false;
+  bool stopflag = false;
+  int status = 0;
+  std::exception_ptr error; // Exception thrown by the producer, if any
+  std::thread producer;
+};
+
+// heliolincStream: October 18, 2026:
+// Returns a HeliolincStream iterator, yielding (outclust, clust2det)
+// for each batch of hyp_per_batch hypotheses as soon as it is ready.
+HeliolincStream *heliolincStream(HeliolincConfig config, py::array_t<hlimage> py_imglog, py::array_t<hldet> py_detvec, py::array_t<tracklet> py_tracklets, py::array_t<longpair> py_trk2det, py::array_t<hlradhyp> py_radhyp, py::array_t<EarthState> earthin, long hyp_per_batch, long maxqueue, long dedup_hyps)
+{
+  cout << "C++ wrapper for streaming heliolinc\n";
+  return(new HeliolincStream(config, py_imglog, py_detvec, py_tracklets, py_trk2det, py_radhyp, earthin, hyp_per_batch, maxqueue, dedup_hyps));
+}
+
+// heliolincCallback: October 18, 2026:
+// Callback form of heliolincStream: calls callback(outclust, clust2det)
+// for each batch, and returns the total number of linkages delivered.
+long heliolincCallback(HeliolincConfig config, py::array_t<hlimage> py_imglog, py::array_t<hldet> py_detvec, py::array_t<tracklet> py_tracklets, py::array_t<longpair> py_trk2det, py::array_t<hlradhyp> py_radhyp, py::array_t<EarthState> earthin, py::function callback, long hyp_per_batch, long maxqueue, long dedup_hyps)
+{
+  cout << "C++ wrapper for heliolinc with per-batch callback\n";
+  HeliolincStream stream(config, py_imglog, py_detvec, py_tracklets, py_trk2det, py_radhyp, earthin, hyp_per_batch, maxqueue, dedup_hyps);
+  long clustnum = 0;
+  while(true) {
+    std::tuple<py::array, py::array> batch;
+    try {
+      batch = stream.next();
+    } catch(py::stop_iteration &) {
+      break;
+    }
+    clustnum += std::get<0>(batch).size();
+    callback(std::get<0>(batch), std::get<1>(batch));
+  }
+  return(clustnum);
+}
+
 template <typename S>
 py::array_t<S> create_recarray(size_t n) {
     return py::array_t<S>(n);
@@ -518,6 +936,7 @@ PYBIND11_MODULE(heliolinx, m) {
     PYBIND11_NUMPY_DTYPE(hlclust, clusternum, posRMS, velRMS, totRMS, astromRMS, pairnum, timespan, uniquepoints, obsnights, metric, rating, reference_MJD, heliohyp0, heliohyp1, heliohyp2, posX, posY, posZ, velX, velY, velZ, orbit_a, orbit_e, orbit_MJD, orbitX, orbitY, orbitZ, orbitVX, orbitVY, orbitVZ, orbit_eval_count);
     PYBIND11_NUMPY_DTYPE(point3d_index, x, y, z, index);
     PYBIND11_NUMPY_DTYPE(glint_trail, x, y, length, PA, linrms, eqrms, magmean, magrms, stepsize, qc1, npt, flashnum);
+    PYBIND11_NUMPY_DTYPE(observatory, obscode, obslon, plxcos, plxsin);
 		     
     NDARRAY_FACTORY(hldet)
     NDARRAY_FACTORY(EarthState)
@@ -528,6 +947,17 @@ PYBIND11_MODULE(heliolinx, m) {
     NDARRAY_FACTORY(hlclust)
     NDARRAY_FACTORY(point3d_index)
     NDARRAY_FACTORY(glint_trail)
+    NDARRAY_FACTORY(observatory)
+
+    // C++-owned vectors of records, viewable from numpy through the
+    // buffer protocol, for the copy-free *_vec entry points.
+    py::bind_vector<std::vector<hldet>>(m, "HldetVector", py::buffer_protocol());
+    py::bind_vector<std::vector<hlimage>>(m, "HlimageVector", py::buffer_protocol());
+    py::bind_vector<std::vector<tracklet>>(m, "TrackletVector", py::buffer_protocol());
+    py::bind_vector<std::vector<longpair>>(m, "LongpairVector", py::buffer_protocol());
+    py::bind_vector<std::vector<hlradhyp>>(m, "HlradhypVector", py::buffer_protocol());
+    py::bind_vector<std::vector<EarthState>>(m, "EarthStateVector", py::buffer_protocol());
+    py::bind_vector<std::vector<hlclust>>(m, "HlclustVector", py::buffer_protocol());
 
 /*    py::class_<hldet>(m, "hldet")
       .def(py::init<double &, double &, double &, float &, float &, float &, float &, float &, float &, int &, std::string &, std::string &, std::string &, long &, long &, long &>());
@@ -590,6 +1020,8 @@ PYBIND11_MODULE(heliolinx, m) {
       .def_readwrite("minimpactpar", &HeliolincConfig::minimpactpar)
       .def_readwrite("use_univar", &HeliolincConfig::use_univar)
       .def_readwrite("max_v_inf", &HeliolincConfig::max_v_inf)
+      .def_readwrite("prescreen", &HeliolincConfig::prescreen)
+      .def_readwrite("compact", &HeliolincConfig::compact)
       .def_readwrite("verbose", &HeliolincConfig::verbose);
 
     // Config class for LinkRefine    
@@ -635,17 +1067,34 @@ PYBIND11_MODULE(heliolinx, m) {
       .def_readwrite("incenDec", &FindGlintsConfig::incenDec)
       .def_readwrite("freq_downscale", &FindGlintsConfig::freq_downscale)
       .def_readwrite("freq_upscale", &FindGlintsConfig::freq_upscale)
-      .def_readwrite("max_phase_err", &FindGlintsConfig::max_phase_err);
+      .def_readwrite("max_phase_err", &FindGlintsConfig::max_phase_err)
+      .def_readwrite("verbose", &FindGlintsConfig::verbose);
+
+    // Iterator returned by heliolincStream
+    py::class_<HeliolincStream>(m, "HeliolincStream")
+      .def("__iter__", [](HeliolincStream &self) -> HeliolincStream & { return self; })
+      .def("__next__", &HeliolincStream::next)
+      .def("close", &HeliolincStream::close, py::call_guard<py::gil_scoped_release>());
 
     
     m.def("iotest02", &iotest02, "A function to test python I/O");
     m.def("observer_coords", &observer_coords, "calculate position of an observer on Earth");
     m.def("observer_vel", &observer_vel, "calculate velocity of an observer on Earth");
+    m.def("makeImageTable", &makeImageTable, "Time-sort detections and build the image table, with observer positions and velocities.", py::arg("detvec"), py::arg("obsarr"), py::arg("earthpos"), py::arg("time_offset") = 0.0);
     m.def("makeTracklets", &makeTracklets,  "Make tracklets from set of detections.");
     m.def("makeTrailedTracklets", &makeTrailedTracklets,  "Make tracklets from set of trailed detections.");
     m.def("heliolinc", &heliolinc,  "Link input tracklets into candidate discoveries.");
     m.def("linkPurify", &linkPurify, "Purify linkages, eliminating duplicates, and rejecting astrometric outliers.");
     m.def("linkPlanarity", &linkPlanarity, "Purify linkages, eliminating duplicates, and rejecting astrometric outliers.");
+    // Overloads on the C++-owned vector classes. pybind11 tries every
+    // overload without implicit conversions first, so these are chosen
+    // for vector arguments rather than converting them to numpy arrays.
+    m.def("heliolinc", &heliolinc_vec, "Link input tracklets into candidate discoveries, without copying the inputs.");
+    m.def("linkPurify", &linkPurify_vec, "Purify linkages, without copying the inputs.");
+    m.def("linkPlanarity", &linkPlanarity_vec, "Purify linkages using planarity, without copying the inputs.");
     m.def("findGlints", &findGlints, "Identify glint trails produced by space junk, using pixel x,y coordinates");
     m.def("findGlintsRadec", &findGlintsRadec, "Identify glint trails produced by space junk, using RA, Dec coordinates");
+    m.def("findGlintsCatalog", &findGlintsCatalog, "Identify glint trails on every image of a catalog, in parallel");
+    m.def("heliolincStream", &heliolincStream, "Run heliolinc in a background thread, yielding linkages batch by batch.", py::arg("config"), py::arg("imglog"), py::arg("detvec"), py::arg("tracklets"), py::arg("trk2det"), py::arg("radhyp"), py::arg("earthpos"), py::arg("hyp_per_batch") = 1, py::arg("maxqueue") = 2, py::arg("dedup_hyps") = 100);
+    m.def("heliolincCallback", &heliolincCallback, "Run heliolinc, calling callback(outclust, clust2det) for each batch of hypotheses.", py::arg("config"), py::arg("imglog"), py::arg("detvec"), py::arg("tracklets"), py::arg("trk2det"), py::arg("radhyp"), py::arg("earthpos"), py::arg("callback"), py::arg("hyp_per_batch") = 1, py::arg("maxqueue") = 2, py::arg("dedup_hyps") = 100);
   }
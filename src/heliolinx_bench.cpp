@@ -0,0 +1,944 @@
+// October 18, 2026: heliolinx_bench.cpp
+// Reproducible benchmark for the main heliolinx pipeline stages.
+// Generates a seeded, synthetic LSST-like survey entirely in memory,
+// and then times make_tracklets7, heliolinc_omp_all, link_purify,
+// and link_planarity on it. Several survey scales (total number of
+// detections) can be run in a single invocation, and the results
+// are written as JSON, with the wall-clock time and the throughput
+// for each stage, so that runs against different versions of the
+// library can be compared directly. Invoked by 'make bench'.
+//
+// The synthetic survey: a block of square fields centered on the
+// opposition point at the middle of the survey, each observed twice
+// per night (a tracklet pair separated by PAIR_INTERVAL), on nights
+// spaced by a fixed cadence. Main-belt-like asteroids are placed at
+// random positions within the block at the central time, and given
+// near-circular, low-inclination heliocentric velocities. They are
+// propagated to each image time with Kepler_fg_func_int, including
+// light-travel time, and observed from the Rubin Observatory site,
+// using observer positions from observer_barycoords01 and a synthetic
+// Earth ephemeris. Detections are subject to a fixed detection
+// efficiency and Gaussian astrometric noise, and random false
+// positives are added to bring the catalog up to the requested size.
+// All randomness derives from the user-supplied seed, and the
+// generated catalog does not depend on the number of threads.
+//
+// With -trigcheck N, the batch trig kernels used by find_pairs and
+// the other projection loops are first timed against the scalar
+// routines they replace, on N random points, and checked against
+// the FASTTRIG_MAXERR_MAS error bound.
+
+#include "solarsyst_dyn_geo01.h"
+#include "cmath"
+
+#define BENCH_OBSCODE "X05"    // Rubin Observatory
+#define BENCH_OBSLON 289.2546
+#define BENCH_PLXCOS 0.865020
+#define BENCH_PLXSIN -0.500901
+#define BENCH_STARTMJD 61100.0 // Start of the synthetic survey
+#define NIGHT_START 0.05       // UT fraction of a day when observations start
+#define FIELD_HALFWIDTH 1.75   // Half-width of square survey fields, in degrees
+#define VISIT_TIME 40.0        // Seconds per visit: 30 sec exposure plus overhead
+#define EXPTIME 30.0           // Exposure time in seconds
+#define PAIR_INTERVAL 2000.0   // Seconds between the two visits to each field on a given night
+#define MAXFIELDS 400          // Field-count limit: larger scales raise the density instead
+#define EARTH_PAD 10.0         // Days of Earth ephemeris on either side of the survey
+#define MINRAD 2.0             // Heliocentric distance range (AU) for synthetic asteroids
+#define MAXRAD 3.4
+#define ASTEROID_BLOCK 1024    // Asteroids per parallel work unit in the generator
+
+static void show_usage()
+{
+  cerr << "Usage: heliolinx_bench -ndet target_detection_count [-ndet another_count ...] -seed random_seed -nights number_of_nights -cadence nightly_cadence(days) -density detections_per_image -fpfrac false_positive_fraction -deteff detection_efficiency -astromsig astrometric_sigma(arcsec) -heliodist heliocentric_dist_vel_acc_file -clustrad clustrad -out output_json_file -verbose verbosity -profile profile_file -trigcheck number_of_points\n";
+  cerr << "\nor, at minimum:\n\n";
+  cerr << "heliolinx_bench -ndet target_detection_count\n";
+}
+
+// bench_rng: Independent random number stream for each asteroid or
+// image, so that the synthetic survey is reproducible regardless of
+// how the work is divided among threads.
+static mt19937_64 bench_rng(long seed, long stream, long substream)
+{
+  seed_seq sseq{(unsigned int)(seed & 0xffffffff), (unsigned int)(seed >> 32), (unsigned int)(stream & 0xffffffff), (unsigned int)(stream >> 32), (unsigned int)substream};
+  return(mt19937_64(sseq));
+}
+
+// bench_earth_orbit: Mean orbital elements of the Earth, with the
+// mean anomaly referred to the epoch mjd so that Kepler2dyn never
+// sees a large argument.
+static asteroid_orbit bench_earth_orbit(double mjd)
+{
+  double meananom = fmod(-2.48284 + 0.98560912*(mjd-51544.5), 360.0);
+  if(meananom<0.0) meananom += 360.0;
+  return(asteroid_orbit("Earth", 1.00000011, 0.01671022, 0.00005, -11.26064, 114.20783, meananom, mjd, 0.98560912, 0.0, 0.0));
+}
+
+// bench_field: Square survey field in the synthetic survey grid.
+class bench_field{
+public:
+  double RA;
+  double Dec;
+  long row;
+  bench_field(double ra, double dec, long row) :RA(ra), Dec(dec), row(row) {}
+};
+
+// bench_survey: The synthetic survey and its ingredients.
+class bench_survey{
+public:
+  vector <hldet> detvec;
+  vector <hlimage> image_log;
+  vector <double> EarthMJD;
+  vector <point3d> Earthpos;
+  vector <point3d> Earthvel;
+  vector <EarthState> earthpos;
+  vector <observatory> observatory_list;
+  long nasteroids = 0;
+  long nreal = 0;
+  long nfalse = 0;
+  double MJDref = 0.0;
+};
+
+// bench_fieldgrid: Lay out the grid of fields, centered on the
+// opposition point at time mjdmid. The grid is stored by row
+// (constant Dec), with rowstart[j] the first field in row j.
+static void bench_fieldgrid(long nfields, double mjdmid, vector <bench_field> &fields, vector <long> &rowstart, double &dec0)
+{
+  double sunra,sundec,ra0,dec,rastep;
+  long nfx,nfy,i,j;
+  sunradec_approx01(mjdmid,sunra,sundec);
+  ra0 = sunra+180.0;
+  if(ra0>=360.0) ra0 -= 360.0;
+  dec0 = -sundec;
+
+  nfx = ceil(sqrt(double(nfields)));
+  nfy = (nfields + nfx - 1)/nfx;
+  fields={};
+  rowstart={};
+  for(j=0;j<nfy;j++) {
+    dec = dec0 + (double(j) - double(nfy-1)*0.5)*2.0*FIELD_HALFWIDTH;
+    rastep = 2.0*FIELD_HALFWIDTH/cos(dec/DEGPRAD);
+    rowstart.push_back(fields.size());
+    for(i=0;i<nfx;i++) {
+      double ra = ra0 + (double(i) - double(nfx-1)*0.5)*rastep;
+      while(ra>=360.0) ra -= 360.0;
+      while(ra<0.0) ra += 360.0;
+      fields.push_back(bench_field(ra,dec,j));
+    }
+  }
+  rowstart.push_back(fields.size());
+}
+
+// bench_findfield: Index of the field containing RA, Dec, or -1.
+static long bench_findfield(const vector <bench_field> &fields, const vector <long> &rowstart, double RA, double Dec)
+{
+  long nrows = rowstart.size()-1;
+  double decbottom = fields[0].Dec - FIELD_HALFWIDTH;
+  long row = floor((Dec - decbottom)/(2.0*FIELD_HALFWIDTH));
+  if(row<0 || row>=nrows) return(-1);
+  long first = rowstart[row];
+  long nfx = rowstart[row+1]-first;
+  double dra = RA - fields[first].RA;
+  while(dra>=180.0) dra -= 360.0;
+  while(dra<-180.0) dra += 360.0;
+  dra += FIELD_HALFWIDTH/cos(fields[first].Dec/DEGPRAD);
+  long col = floor(dra*cos(fields[first].Dec/DEGPRAD)/(2.0*FIELD_HALFWIDTH));
+  if(col<0 || col>=nfx) return(-1);
+  return(first+col);
+}
+
+// bench_observe: Astrometric position of the object with heliocentric
+// state targpos, targvel at time mjdtarg (TT), as seen at image time
+// mjd (UT) by an observer at obspos. Positions are in km, velocities
+// in km/sec. Includes light-travel time.
+static void bench_observe(const point3d &targpos, const point3d &targvel, double mjdtarg, double mjd, const point3d &obspos, double &RA, double &Dec)
+{
+  point3d pos = point3d(0,0,0);
+  point3d vel = point3d(0,0,0);
+  double tt = mjd + TTDELTAT/SOLARDAY;
+  double lighttime=0.0;
+  int i=0;
+  Kepler_fg_func_int(GMSUN_KM3_SEC2, mjdtarg, targpos, targvel, tt, pos, vel);
+  for(i=0;i<2;i++) {
+    point3d rel = point3d(pos.x-obspos.x, pos.y-obspos.y, pos.z-obspos.z);
+    lighttime = vecabs3d(rel)/(CLIGHT/1000.0)/SOLARDAY;
+    Kepler_fg_func_int(GMSUN_KM3_SEC2, mjdtarg, targpos, targvel, tt-lighttime, pos, vel);
+  }
+  point3d unitvec = point3d(pos.x-obspos.x, pos.y-obspos.y, pos.z-obspos.z);
+  vecnorm3d(unitvec);
+  stateunit_to_celestial(unitvec,RA,Dec);
+}
+
+// bench_make_survey: Generate a synthetic survey with (nearly exactly)
+// ndet detections.
+static int bench_make_survey(long ndet, long seed, int nights, double cadence, double density, double fpfrac, double deteff, double astromsig, bench_survey &survey, int verbose)
+{
+  long nfields,fieldct,imct,i,j;
+  int nightct,pass;
+  double mjd,dec0;
+  vector <bench_field> fields;
+  vector <long> rowstart;
+  point3d p3 = point3d(0,0,0);
+  point3d v3 = point3d(0,0,0);
+
+  survey = bench_survey();
+  survey.observatory_list.push_back(observatory(BENCH_OBSCODE, BENCH_OBSLON, BENCH_PLXCOS, BENCH_PLXSIN));
+
+  // Lay out the survey fields. Every field yields 2*nights images.
+  nfields = ceil(double(ndet)/(2.0*nights*density));
+  if(nfields<1) nfields=1;
+  if(nfields>MAXFIELDS) nfields=MAXFIELDS;
+  double mjdmid = BENCH_STARTMJD + NIGHT_START + 0.5*cadence*double(nights-1);
+  bench_fieldgrid(nfields, mjdmid, fields, rowstart, dec0);
+  nfields = fields.size();
+  if(fabs(dec0)+FIELD_HALFWIDTH*double(rowstart.size()) > 85.0) {
+    cerr << "ERROR: synthetic survey grid of " << nfields << " fields extends too close to a celestial pole\n";
+    return(1);
+  }
+
+  // Synthetic heliocentric ephemeris for the Earth, in km and km/sec,
+  // with one-day spacing like the JPL Horizons files used in production.
+  double ephstart = floor(BENCH_STARTMJD - EARTH_PAD);
+  double ephend = ceil(BENCH_STARTMJD + cadence*double(nights) + EARTH_PAD);
+  for(mjd=ephstart; mjd<=ephend; mjd+=1.0) {
+    Kepler2dyn(mjd, bench_earth_orbit(mjd), p3, v3);
+    p3 = point3d(p3.x*AU_KM, p3.y*AU_KM, p3.z*AU_KM);
+    v3 = point3d(v3.x*AU_KM/SOLARDAY, v3.y*AU_KM/SOLARDAY, v3.z*AU_KM/SOLARDAY);
+    survey.EarthMJD.push_back(mjd);
+    survey.Earthpos.push_back(p3);
+    survey.Earthvel.push_back(v3);
+    survey.earthpos.push_back(EarthState(mjd, p3.x, p3.y, p3.z, v3.x, v3.y, v3.z));
+  }
+
+  // Schedule the images. Fields are visited in blocks small enough that
+  // the whole block can be covered within PAIR_INTERVAL, and each block
+  // is then revisited to create the tracklet pairs.
+  long blocksize = PAIR_INTERVAL/VISIT_TIME;
+  vector <long> imgfield;
+  vector <int> imgnight;
+  vector <vector <long>> fieldimgs; // Images for each field and night
+  fieldimgs.resize(nfields*nights);
+  for(nightct=0;nightct<nights;nightct++) {
+    mjd = BENCH_STARTMJD + NIGHT_START + cadence*double(nightct);
+    for(fieldct=0; fieldct<nfields; fieldct+=blocksize) {
+      long blockend = fieldct+blocksize;
+      if(blockend>nfields) blockend=nfields;
+      double blockstart = mjd;
+      for(pass=0;pass<2;pass++) {
+	if(pass==1 && mjd < blockstart + PAIR_INTERVAL/SOLARDAY) mjd = blockstart + PAIR_INTERVAL/SOLARDAY;
+	for(i=fieldct;i<blockend;i++) {
+	  fieldimgs[nightct*nfields+i].push_back(survey.image_log.size());
+	  survey.image_log.push_back(hlimage(mjd, fields[i].RA, fields[i].Dec, BENCH_OBSCODE, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, EXPTIME));
+	  imgfield.push_back(i);
+	  imgnight.push_back(nightct);
+	  mjd += VISIT_TIME/SOLARDAY;
+	}
+      }
+    }
+  }
+  long nimages = survey.image_log.size();
+  survey.MJDref = 0.5*(survey.image_log[0].MJD + survey.image_log[nimages-1].MJD);
+
+  // Observer position for each image, and for the middle of each night.
+  vector <point3d> imgobs(nimages, point3d(0,0,0));
+  for(imct=0;imct<nimages;imct++) {
+    observer_barycoords01(survey.image_log[imct].MJD, 5, BENCH_OBSLON, BENCH_PLXCOS, BENCH_PLXSIN, survey.EarthMJD, survey.Earthpos, imgobs[imct]);
+  }
+  vector <long> nightfirst(nights,nimages);
+  vector <long> nightlast(nights,0);
+  vector <long> nightmid(nights,0);
+  for(imct=0;imct<nimages;imct++) {
+    if(imct<nightfirst[imgnight[imct]]) nightfirst[imgnight[imct]] = imct;
+    nightlast[imgnight[imct]] = imct;
+  }
+  for(nightct=0;nightct<nights;nightct++) nightmid[nightct] = (nightfirst[nightct]+nightlast[nightct])/2;
+
+  // Number of asteroids: each one yields about 2*nights*deteff detections.
+  long nreal_target = double(ndet)*(1.0-fpfrac);
+  survey.nasteroids = ceil(double(nreal_target)/(2.0*double(nights)*deteff));
+  if(survey.nasteroids<1) survey.nasteroids=1;
+  point3d earthmid = point3d(0,0,0);
+  observer_barycoords01(mjdmid, 5, BENCH_OBSLON, BENCH_PLXCOS, BENCH_PLXSIN, survey.EarthMJD, survey.Earthpos, earthmid);
+  double tmid = mjdmid + TTDELTAT/SOLARDAY;
+
+  if(verbose>=1) cout << "Synthetic survey: " << nfields << " fields, " << nights << " nights, " << nimages << " images, " << survey.nasteroids << " asteroids\n";
+
+  long nblocks = (survey.nasteroids + ASTEROID_BLOCK - 1)/ASTEROID_BLOCK;
+  vector <vector <hldet>> blockdets(nblocks);
+
+#pragma omp parallel for schedule(dynamic)
+  for(long blockct=0; blockct<nblocks; blockct++) {
+    long astct,astend;
+    astend = (blockct+1)*ASTEROID_BLOCK;
+    if(astend > survey.nasteroids) astend = survey.nasteroids;
+    for(astct=blockct*ASTEROID_BLOCK; astct<astend; astct++) {
+      mt19937_64 rng = bench_rng(seed, astct, 0);
+      uniform_real_distribution<double> unif(0.0,1.0);
+      normal_distribution<double> gauss(0.0,1.0);
+      // Position in the field block at the central time.
+      long f = unif(rng)*double(nfields);
+      if(f>=nfields) f = nfields-1;
+      double dec = fields[f].Dec + (2.0*unif(rng)-1.0)*FIELD_HALFWIDTH;
+      double ra = fields[f].RA + (2.0*unif(rng)-1.0)*FIELD_HALFWIDTH/cos(fields[f].Dec/DEGPRAD);
+      double heliorad = (MINRAD + (MAXRAD-MINRAD)*unif(rng))*AU_KM;
+      point3d unitvec = point3d(0,0,0);
+      celestial_to_stateunit(ra,dec,unitvec);
+      // Solve |earthmid + delta*unitvec| = heliorad for the geocentric distance delta.
+      double edotu = dotprod3d(earthmid,unitvec);
+      double delta = -edotu + sqrt(edotu*edotu - dotprod3d(earthmid,earthmid) + heliorad*heliorad);
+      point3d targpos = point3d(earthmid.x + delta*unitvec.x, earthmid.y + delta*unitvec.y, earthmid.z + delta*unitvec.z);
+      // Near-circular, prograde, low-inclination velocity.
+      double incl = fabs(gauss(rng))*8.0/DEGPRAD;
+      double node = unif(rng)*2.0*M_PI;
+      point3d pole = point3d(sin(incl)*sin(node), -sin(incl)*cos(node), cos(incl));
+      point3d radial = targpos;
+      vecnorm3d(radial);
+      point3d tangent = crossprod3d(pole,radial);
+      vecnorm3d(tangent);
+      double speed = sqrt(GMSUN_KM3_SEC2/heliorad)*(1.0 + 0.05*gauss(rng));
+      double flight = 0.03*gauss(rng);
+      point3d targvel = point3d(speed*(tangent.x*cos(flight) + radial.x*sin(flight)), speed*(tangent.y*cos(flight) + radial.y*sin(flight)), speed*(tangent.z*cos(flight) + radial.z*sin(flight)));
+      double basemag = 20.0 + 4.5*unif(rng);
+
+      for(int night=0; night<nights; night++) {
+	// Coarse position at the middle of the night identifies the field
+	long midimg = nightmid[night];
+	double RA,Dec;
+	bench_observe(targpos, targvel, tmid, survey.image_log[midimg].MJD, imgobs[midimg], RA, Dec);
+	long field = bench_findfield(fields, rowstart, RA, Dec);
+	if(field<0) continue;
+	const vector <long> &visits = fieldimgs[night*nfields+field];
+	for(long k=0; k<long(visits.size()); k++) {
+	  long img = visits[k];
+	  // Draw all the random numbers first, so the stream stays
+	  // aligned whether or not this detection survives.
+	  double detroll = unif(rng);
+	  double noisera = gauss(rng)*astromsig/3600.0;
+	  double noisedec = gauss(rng)*astromsig/3600.0;
+	  double magnoise = 0.1*gauss(rng);
+	  bench_observe(targpos, targvel, tmid, survey.image_log[img].MJD, imgobs[img], RA, Dec);
+	  if(bench_findfield(fields, rowstart, RA, Dec) != field || detroll>deteff) continue;
+	  Dec += noisedec;
+	  RA += noisera/cos(Dec/DEGPRAD);
+	  if(RA>=360.0) RA -= 360.0;
+	  if(RA<0.0) RA += 360.0;
+	  blockdets[blockct].push_back(hldet(survey.image_log[img].MJD, RA, Dec, basemag+magnoise, 0.0, 90.0, 0.1, astromsig, astromsig, img, "S" + to_string(astct), "r", BENCH_OBSCODE, astct+1, 0, 0));
+	}
+      }
+    }
+  }
+  for(i=0;i<nblocks;i++) {
+    survey.detvec.insert(survey.detvec.end(), blockdets[i].begin(), blockdets[i].end());
+    blockdets[i] = {};
+  }
+  survey.nreal = survey.detvec.size();
+
+  // False positives, spread uniformly over the images.
+  survey.nfalse = ndet - survey.nreal;
+  if(survey.nfalse<0) survey.nfalse=0;
+  vector <vector <hldet>> imgdets(nimages);
+#pragma omp parallel for schedule(dynamic)
+  for(long img=0; img<nimages; img++) {
+    mt19937_64 rng = bench_rng(seed, img, 1);
+    uniform_real_distribution<double> unif(0.0,1.0);
+    long nfp = survey.nfalse/nimages + (img < survey.nfalse%nimages ? 1 : 0);
+    const bench_field &fld = fields[imgfield[img]];
+    for(long k=0; k<nfp; k++) {
+      double Dec = fld.Dec + (2.0*unif(rng)-1.0)*FIELD_HALFWIDTH;
+      double RA = fld.RA + (2.0*unif(rng)-1.0)*FIELD_HALFWIDTH/cos(fld.Dec/DEGPRAD);
+      if(RA>=360.0) RA -= 360.0;
+      if(RA<0.0) RA += 360.0;
+      double mag = 20.0 + 4.5*unif(rng);
+      imgdets[img].push_back(hldet(survey.image_log[img].MJD, RA, Dec, mag, 0.0, 90.0, 0.1, astromsig, astromsig, img, "F" + to_string(img) + "_" + to_string(k), "r", BENCH_OBSCODE, 0, 0, 0));
+    }
+  }
+  for(imct=0;imct<nimages;imct++) {
+    survey.detvec.insert(survey.detvec.end(), imgdets[imct].begin(), imgdets[imct].end());
+    imgdets[imct] = {};
+  }
+
+  // Number the detections as an input file would be, then time-sort
+  // them and load the image table exactly as make_tracklets does.
+  for(j=0;j<long(survey.detvec.size());j++) survey.detvec[j].index = j;
+  stable_sort(survey.detvec.begin(), survey.detvec.end(), early_hldet());
+  int status = load_image_table(survey.image_log, survey.detvec, 0.0, survey.observatory_list, survey.EarthMJD, survey.Earthpos, survey.Earthvel);
+  if(status!=0) {
+    cerr << "ERROR: load_image_table failed with status " << status << " on the synthetic survey\n";
+    return(status);
+  }
+  return(0);
+}
+
+// bench_stage: Timing result for one pipeline stage.
+class bench_stage{
+public:
+  string name;
+  double seconds;
+  long input;
+  long output;
+  string unit;
+  bench_stage(string name, double seconds, long input, long output, string unit) :name(name), seconds(seconds), input(input), output(output), unit(unit) {}
+};
+
+// bench_kernel: Timing and accuracy result for one batch trig kernel,
+// compared to the scalar library routine it replaces.
+class bench_kernel{
+public:
+  string name;
+  double scalar_seconds;
+  double batch_seconds;
+  double maxerr_mas;
+  bench_kernel(string name, double scalar_seconds, double batch_seconds, double maxerr_mas) :name(name), scalar_seconds(scalar_seconds), batch_seconds(batch_seconds), maxerr_mas(maxerr_mas) {}
+};
+
+// bench_trig_kernels: Microbenchmark and accuracy check of the batch
+// trig kernels (sincos_batch, atan2_batch, celeproj01_batch,
+// distradec02_batch, distradec02_xy_batch, celestial_to_stateunit_batch)
+// against the scalar routines.
+// The points cover the whole sky, and each is paired with a
+// reference point within a few degrees, as in find_pairs.
+// Errors are reported in milliarcseconds: for the position angle
+// this is the angle times the separation, i.e. the on-sky error,
+// and for sine, cosine, and unit vectors it is the error in radians.
+static int bench_trig_kernels(long npts, long seed, vector <bench_kernel> &kernels)
+{
+  vector <double> ra0(npts), dec0(npts), ra(npts), dec(npts);
+  vector <double> dist(npts), pa(npts), x(npts), y(npts);
+  vector <point3d> unitvec(npts, point3d(0.0,0.0,0.0));
+  double clocktime=0.0;
+  double scalartime=0.0;
+  double maxerr=0.0;
+  double sdist=0.0;
+  double spa=0.0;
+  double dpa=0.0;
+  long i=0;
+
+  mt19937_64 rng = bench_rng(seed, -1, 0);
+  uniform_real_distribution<double> unit(0.0,1.0);
+  for(i=0; i<npts; i++) {
+    ra0[i] = 360.0*unit(rng);
+    dec0[i] = asin(2.0*unit(rng)-1.0)*DEGPRAD;
+    ra[i] = ra0[i] + 6.0*(unit(rng)-0.5);
+    dec[i] = dec0[i] + 6.0*(unit(rng)-0.5);
+    if(dec[i]>90.0) dec[i] = 180.0 - dec[i];
+    if(dec[i]<-90.0) dec[i] = -180.0 - dec[i];
+    if(ra[i]<0.0) ra[i] += 360.0;
+    if(ra[i]>=360.0) ra[i] -= 360.0;
+  }
+
+  // Scalar timing: distradec02, plus the sin/cos projection find_pairs applies to it.
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i++) {
+    distradec02(ra0[i], dec0[i], ra[i], dec[i], &dist[i], &pa[i]);
+    x[i] = dist[i]*sin(pa[i]/DEGPRAD);
+    y[i] = dist[i]*cos(pa[i]/DEGPRAD);
+  }
+  scalartime = omp_get_wtime() - clocktime;
+  // The batch kernels take a single reference point per call:
+  // time them in short runs, as find_pairs calls them per image.
+  vector <double> bdist(npts), bpa(npts), bx(npts), by(npts);
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i+=1000) distradec02_batch(ra0[i], dec0[i], min(1000L,npts-i), &ra[i], &dec[i], &bdist[i], &bpa[i]);
+  double batchtime = omp_get_wtime() - clocktime;
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i+=1000) distradec02_xy_batch(ra0[i], dec0[i], min(1000L,npts-i), &ra[i], &dec[i], &bx[i], &by[i]);
+  double xytime = omp_get_wtime() - clocktime;
+
+  // Accuracy: recompute the batch results with each point's own reference point.
+  for(i=0; i<npts; i++) {
+    distradec02_batch(ra0[i], dec0[i], 1, &ra[i], &dec[i], &bdist[i], &bpa[i]);
+    distradec02_xy_batch(ra0[i], dec0[i], 1, &ra[i], &dec[i], &bx[i], &by[i]);
+  }
+  maxerr=0.0;
+  for(i=0; i<npts; i++) {
+    sdist = fabs(bdist[i]-dist[i]);
+    dpa = fabs(bpa[i]-pa[i]);
+    if(dpa>180.0) dpa = 360.0-dpa;
+    spa = dpa/DEGPRAD*dist[i];
+    if(sdist>maxerr) maxerr=sdist;
+    if(spa>maxerr) maxerr=spa;
+  }
+  kernels.push_back(bench_kernel("distradec02_batch", scalartime, batchtime, maxerr*ASECPRAD/DEGPRAD*1000.0));
+  maxerr=0.0;
+  for(i=0; i<npts; i++) {
+    if(fabs(bx[i]-x[i])>maxerr) maxerr = fabs(bx[i]-x[i]);
+    if(fabs(by[i]-y[i])>maxerr) maxerr = fabs(by[i]-y[i]);
+  }
+  kernels.push_back(bench_kernel("distradec02_xy_batch", scalartime, xytime, maxerr*ASECPRAD/DEGPRAD*1000.0));
+
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i++) celestial_to_stateunit(ra[i], dec[i], unitvec[i]);
+  scalartime = omp_get_wtime() - clocktime;
+  vector <point3d> bunitvec(npts, point3d(0.0,0.0,0.0));
+  clocktime = omp_get_wtime();
+  celestial_to_stateunit_batch(npts, ra.data(), dec.data(), bunitvec.data());
+  batchtime = omp_get_wtime() - clocktime;
+  maxerr=0.0;
+  for(i=0; i<npts; i++) {
+    double err = vecabs3d(point3d(bunitvec[i].x-unitvec[i].x, bunitvec[i].y-unitvec[i].y, bunitvec[i].z-unitvec[i].z));
+    if(err>maxerr) maxerr=err;
+  }
+  kernels.push_back(bench_kernel("celestial_to_stateunit_batch", scalartime, batchtime, maxerr*ASECPRAD*1000.0));
+
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i++) unitvec[i] = celeproj01(ra[i], dec[i]);
+  scalartime = omp_get_wtime() - clocktime;
+  clocktime = omp_get_wtime();
+  celeproj01_batch(npts, ra.data(), dec.data(), bunitvec.data());
+  batchtime = omp_get_wtime() - clocktime;
+  maxerr=0.0;
+  for(i=0; i<npts; i++) {
+    double err = vecabs3d(point3d(bunitvec[i].x-unitvec[i].x, bunitvec[i].y-unitvec[i].y, bunitvec[i].z-unitvec[i].z));
+    if(err>maxerr) maxerr=err;
+  }
+  kernels.push_back(bench_kernel("celeproj01_batch", scalartime, batchtime, maxerr*ASECPRAD*1000.0));
+
+  // Sine and cosine of angles spanning several turns, reusing
+  // the dist and pa arrays for the scalar results.
+  vector <double> angle(npts), bsin(npts), bcos(npts);
+  for(i=0; i<npts; i++) angle[i] = 8.0*M_PI*(unit(rng)-0.5);
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i++) {
+    dist[i] = sin(angle[i]);
+    pa[i] = cos(angle[i]);
+  }
+  scalartime = omp_get_wtime() - clocktime;
+  clocktime = omp_get_wtime();
+  sincos_batch(npts, angle.data(), bsin.data(), bcos.data());
+  batchtime = omp_get_wtime() - clocktime;
+  maxerr=0.0;
+  for(i=0; i<npts; i++) {
+    if(fabs(bsin[i]-dist[i])>maxerr) maxerr = fabs(bsin[i]-dist[i]);
+    if(fabs(bcos[i]-pa[i])>maxerr) maxerr = fabs(bcos[i]-pa[i]);
+  }
+  kernels.push_back(bench_kernel("sincos_batch", scalartime, batchtime, maxerr*ASECPRAD*1000.0));
+
+  // Arctangent of points in a square centered on the origin.
+  for(i=0; i<npts; i++) {
+    x[i] = 2.0*unit(rng)-1.0;
+    y[i] = 2.0*unit(rng)-1.0;
+  }
+  clocktime = omp_get_wtime();
+  for(i=0; i<npts; i++) angle[i] = atan2(y[i], x[i]);
+  scalartime = omp_get_wtime() - clocktime;
+  clocktime = omp_get_wtime();
+  atan2_batch(npts, y.data(), x.data(), bx.data());
+  batchtime = omp_get_wtime() - clocktime;
+  maxerr=0.0;
+  for(i=0; i<npts; i++) {
+    if(fabs(bx[i]-angle[i])>maxerr) maxerr = fabs(bx[i]-angle[i]);
+  }
+  kernels.push_back(bench_kernel("atan2_batch", scalartime, batchtime, maxerr*ASECPRAD*1000.0));
+
+  int status=0;
+  for(i=0; i<long(kernels.size()); i++) {
+    cout << kernels[i].name << ": scalar " << fixed << setprecision(4) << kernels[i].scalar_seconds << " sec, batch " << kernels[i].batch_seconds << " sec, speedup " << setprecision(2) << kernels[i].scalar_seconds/kernels[i].batch_seconds << scientific << setprecision(3) << ", max error " << kernels[i].maxerr_mas << " mas\n";
+    cout << fixed;
+    if(!(kernels[i].maxerr_mas < FASTTRIG_MAXERR_MAS)) {
+      cerr << "ERROR: " << kernels[i].name << " error " << kernels[i].maxerr_mas << " mas exceeds the bound of " << FASTTRIG_MAXERR_MAS << " mas\n";
+      status=1;
+    }
+  }
+  return(status);
+}
+
+int main(int argc, char *argv[])
+{
+  string profilefile;
+  vector <long> scales;
+  long seed = 1;
+  int nights = 8;
+  double cadence = 2.0;
+  double density = 2000.0;
+  double fpfrac = 0.5;
+  double deteff = 0.95;
+  double astromsig = 0.1;
+  double clustrad = 2.0e5;
+  string hypfile;
+  string outfile = "bench_results.json";
+  int verbose = 0;
+  long trigpts = 0;
+  vector <hlradhyp> radhyp;
+  ofstream outstream1;
+  ofstream nullstream;
+  long i=0;
+  long scalect=0;
+  int status=0;
+
+  if(argc<3) {
+    show_usage();
+    return(1);
+  }
+
+  i=1;
+  while(i<argc) {
+    cout << "Checking out argv " << i << " of " << argc << ".\n";
+    if(string(argv[i]) == "-ndet" || string(argv[i]) == "-n" || string(argv[i]) == "-scale" || string(argv[i]) == "--ndet" || string(argv[i]) == "--scale") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	scales.push_back(stod(argv[++i]));
+	i++;
+      }
+      else {
+	cerr << "Target detection count keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-seed" || string(argv[i]) == "--seed") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	seed=stol(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Random seed keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-nights" || string(argv[i]) == "-nightnum" || string(argv[i]) == "--nights") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	nights=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Number of nights keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-cadence" || string(argv[i]) == "--cadence") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	cadence=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Cadence keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-density" || string(argv[i]) == "-detdensity" || string(argv[i]) == "--density") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	density=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Detection density keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-fpfrac" || string(argv[i]) == "-falsefrac" || string(argv[i]) == "--fpfrac") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	fpfrac=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "False positive fraction keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-deteff" || string(argv[i]) == "-efficiency" || string(argv[i]) == "--deteff") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	deteff=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Detection efficiency keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-astromsig" || string(argv[i]) == "-sig" || string(argv[i]) == "--astromsig") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	astromsig=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Astrometric sigma keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-heliodist" || string(argv[i]) == "-hdist" || string(argv[i]) == "-heliohyp" || string(argv[i]) == "--heliodist") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	hypfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Heliocentric hypothesis file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-clustrad" || string(argv[i]) == "-crad" || string(argv[i]) == "--clustrad") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	clustrad=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Clustering radius keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-out" || string(argv[i]) == "-outfile" || string(argv[i]) == "--out") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	outfile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	verbose=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Verbosity keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-trigcheck" || string(argv[i]) == "--trigcheck") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	trigpts=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Trig kernel check keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else {
+      cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
+      i++;
+    }
+  }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
+  if(scales.size()<=0 && trigpts<=0) {
+    cerr << "\nERROR: at least one target detection count must be specified\n\n";
+    show_usage();
+    return(1);
+  }
+  if(trigpts<0 || nights<3 || cadence<=0.0 || density<=0.0 || fpfrac<0.0 || fpfrac>=1.0 || deteff<=0.0 || deteff>1.0 || astromsig<0.0) {
+    cerr << "\nERROR: invalid survey parameters: need at least 3 nights, positive cadence and density,\n";
+    cerr << "false positive fraction in [0,1), and detection efficiency in (0,1]\n\n";
+    show_usage();
+    return(1);
+  }
+
+  if(hypfile.size()>0) {
+    status=read_radhyp_file(hypfile, radhyp, verbose);
+    if(status!=0) {
+      cerr << "ERROR: could not successfully read accleration file " << hypfile << "\n";
+      cerr << "read_radhyp_file returned status = " << status << ".\n";
+      return(1);
+    }
+  } else {
+    // Default hypothesis grid, matched to the synthetic main-belt population.
+    double heliorad,rdot;
+    for(heliorad=MINRAD; heliorad<=MAXRAD+0.001; heliorad+=0.1) {
+      for(rdot=-0.0008; rdot<=0.0008+1.0e-9; rdot+=0.0004) {
+	radhyp.push_back(hlradhyp(heliorad,rdot,0.0));
+      }
+    }
+  }
+
+  cout << "Benchmarking " << scales.size() << " survey scales with random seed " << seed << "\n";
+  cout << nights << " nights with cadence " << cadence << " days, " << density << " detections per image\n";
+  cout << "false positive fraction " << fpfrac << ", detection efficiency " << deteff << ", astrometric sigma " << astromsig << " arcsec\n";
+  cout << radhyp.size() << " heliocentric hypotheses, clustering radius " << clustrad << " km\n";
+  cout << "Results will be written to " << outfile << "\n";
+
+  outstream1.open(outfile);
+  if(!outstream1) {
+    cerr << "ERROR: can't open output file " << outfile << "\n";
+    return(1);
+  }
+  outstream1 << "{\n";
+  outstream1 << "  \"benchmark\": \"heliolinx_bench\",\n";
+  outstream1 << "  \"seed\": " << seed << ",\n";
+  outstream1 << "  \"threads\": " << omp_get_max_threads() << ",\n";
+  outstream1 << "  \"nights\": " << nights << ",\n";
+  outstream1 << fixed << setprecision(4) << "  \"cadence_days\": " << cadence << ",\n";
+  outstream1 << "  \"density_per_image\": " << density << ",\n";
+  outstream1 << "  \"false_positive_fraction\": " << fpfrac << ",\n";
+  outstream1 << "  \"detection_efficiency\": " << deteff << ",\n";
+  outstream1 << "  \"astrometric_sigma_arcsec\": " << astromsig << ",\n";
+  outstream1 << "  \"hypotheses\": " << radhyp.size() << ",\n";
+  if(trigpts>0) {
+    vector <bench_kernel> kernels;
+    cout << "\nChecking batch trig kernels on " << trigpts << " points\n";
+    status = bench_trig_kernels(trigpts, seed, kernels);
+    outstream1 << "  \"kernel_points\": " << trigpts << ",\n";
+    outstream1 << "  \"kernels\": [\n";
+    for(i=0;i<long(kernels.size());i++) {
+      outstream1 << "    {\"kernel\": \"" << kernels[i].name << "\", ";
+      outstream1 << fixed << setprecision(4) << "\"scalar_seconds\": " << kernels[i].scalar_seconds << ", ";
+      outstream1 << "\"batch_seconds\": " << kernels[i].batch_seconds << ", ";
+      outstream1 << scientific << setprecision(3) << "\"max_error_mas\": " << kernels[i].maxerr_mas << "}";
+      outstream1 << fixed << (i+1<long(kernels.size()) ? ",\n" : "\n");
+    }
+    outstream1 << "  ],\n";
+    if(status!=0) {
+      cerr << "ERROR: batch trig kernels failed the accuracy check\n";
+      outstream1 << "  \"runs\": []\n}\n";
+      return(status);
+    }
+  }
+  outstream1 << "  \"runs\": [\n";
+
+  // The library stages report their progress at length on cout:
+  // keep that out of the way unless it was asked for.
+  streambuf *coutbuf = cout.rdbuf();
+  nullstream.open("/dev/null");
+
+  for(scalect=0; scalect<long(scales.size()); scalect++) {
+    bench_survey survey;
+    vector <bench_stage> stages;
+    vector <hldet> pairdets;
+    vector <tracklet> tracklets;
+    vector <longpair> trk2det;
+    vector <hlclust> hlclusts;
+    vector <longpair> hlclust2det;
+    vector <hlclust> purclusts;
+    vector <longpair> purclust2det;
+    vector <hlclust> planclusts;
+    vector <longpair> planclust2det;
+    double clocktime=0.0;
+
+    cout << "\nScale " << scalect+1 << " of " << scales.size() << ": " << scales[scalect] << " detections\n";
+    clocktime = omp_get_wtime();
+    status = bench_make_survey(scales[scalect], seed, nights, cadence, density, fpfrac, deteff, astromsig, survey, verbose);
+    if(status!=0) {
+      cerr << "ERROR: synthetic survey generation failed with status " << status << "\n";
+      return(status);
+    }
+    double gentime = omp_get_wtime() - clocktime;
+    cout << "Generated " << survey.detvec.size() << " detections (" << survey.nreal << " real, " << survey.nfalse << " false) on " << survey.image_log.size() << " images from " << survey.nasteroids << " asteroids in " << fixed << setprecision(3) << gentime << " seconds\n";
+
+    MakeTrackletsConfig mtconfig;
+    mtconfig.imagerad = FIELD_HALFWIDTH*sqrt(2.0) + 0.1;
+    mtconfig.exptime = EXPTIME;
+    mtconfig.verbose = verbose;
+    vector <hldet> detvec = survey.detvec;
+    if(verbose<=0) cout.rdbuf(nullstream.rdbuf());
+    clocktime = omp_get_wtime();
+    status = make_tracklets7(detvec, survey.image_log, mtconfig, pairdets, tracklets, trk2det);
+    stages.push_back(bench_stage("make_tracklets7", omp_get_wtime()-clocktime, survey.detvec.size(), tracklets.size(), "detections"));
+    cout.rdbuf(coutbuf);
+    if(status!=0) {
+      cerr << "ERROR: make_tracklets7 failed with status " << status << "\n";
+      return(status);
+    }
+    detvec = {};
+    cout << "make_tracklets7: " << tracklets.size() << " tracklets in " << stages.back().seconds << " seconds\n";
+
+    HeliolincConfig hlconfig;
+    hlconfig.MJDref = survey.MJDref;
+    hlconfig.clustrad = clustrad;
+    hlconfig.verbose = verbose;
+    if(verbose<=0) cout.rdbuf(nullstream.rdbuf());
+    clocktime = omp_get_wtime();
+    status = heliolinc_omp_all(survey.image_log, pairdets, tracklets, trk2det, radhyp, survey.earthpos, hlconfig, hlclusts, hlclust2det);
+    stages.push_back(bench_stage("heliolinc_omp_all", omp_get_wtime()-clocktime, pairdets.size(), hlclusts.size(), "detections"));
+    cout.rdbuf(coutbuf);
+    if(status!=0) {
+      cerr << "ERROR: heliolinc_omp_all failed with status " << status << "\n";
+      return(status);
+    }
+    cout << "heliolinc_omp_all: " << hlclusts.size() << " linkages in " << stages.back().seconds << " seconds\n";
+
+    LinkPurifyConfig lpconfig;
+    lpconfig.verbose = verbose;
+    if(verbose<=0) cout.rdbuf(nullstream.rdbuf());
+    clocktime = omp_get_wtime();
+    status = link_purify(survey.image_log, pairdets, hlclusts, hlclust2det, lpconfig, purclusts, purclust2det);
+    stages.push_back(bench_stage("link_purify", omp_get_wtime()-clocktime, hlclust2det.size(), purclusts.size(), "cluster_detections"));
+    cout.rdbuf(coutbuf);
+    if(status!=0) {
+      cerr << "ERROR: link_purify failed with status " << status << "\n";
+      return(status);
+    }
+    cout << "link_purify: " << purclusts.size() << " linkages in " << stages.back().seconds << " seconds\n";
+
+    if(verbose<=0) cout.rdbuf(nullstream.rdbuf());
+    clocktime = omp_get_wtime();
+    status = link_planarity(survey.image_log, pairdets, hlclusts, hlclust2det, lpconfig, planclusts, planclust2det);
+    stages.push_back(bench_stage("link_planarity", omp_get_wtime()-clocktime, hlclust2det.size(), planclusts.size(), "cluster_detections"));
+    cout.rdbuf(coutbuf);
+    if(status!=0) {
+      cerr << "ERROR: link_planarity failed with status " << status << "\n";
+      return(status);
+    }
+    cout << "link_planarity: " << planclusts.size() << " linkages in " << stages.back().seconds << " seconds\n";
+
+    // Count purified linkages made up entirely of one synthetic asteroid,
+    // as a sanity check that the benchmark is doing real work.
+    long pure=0;
+    long clustct=0;
+    i=0;
+    while(i<long(purclust2det.size())) {
+      clustct = purclust2det[i].i1;
+      long obj = pairdets[purclust2det[i].i2].known_obj;
+      int ispure = (obj>0);
+      while(i<long(purclust2det.size()) && purclust2det[i].i1==clustct) {
+	if(pairdets[purclust2det[i].i2].known_obj != obj) ispure=0;
+	i++;
+      }
+      pure += ispure;
+    }
+    cout << pure << " of " << purclusts.size() << " purified linkages are pure\n";
+
+    outstream1 << "    {\n";
+    outstream1 << "      \"target_detections\": " << scales[scalect] << ",\n";
+    outstream1 << "      \"detections\": " << survey.detvec.size() << ",\n";
+    outstream1 << "      \"real_detections\": " << survey.nreal << ",\n";
+    outstream1 << "      \"false_detections\": " << survey.nfalse << ",\n";
+    outstream1 << "      \"asteroids\": " << survey.nasteroids << ",\n";
+    outstream1 << "      \"images\": " << survey.image_log.size() << ",\n";
+    outstream1 << "      \"pure_linkages\": " << pure << ",\n";
+    outstream1 << fixed << setprecision(4) << "      \"generate_seconds\": " << gentime << ",\n";
+    outstream1 << "      \"stages\": [\n";
+    for(i=0;i<long(stages.size());i++) {
+      double throughput = stages[i].seconds>0.0 ? double(stages[i].input)/stages[i].seconds : 0.0;
+      outstream1 << "        {\"stage\": \"" << stages[i].name << "\", ";
+      outstream1 << fixed << setprecision(4) << "\"seconds\": " << stages[i].seconds << ", ";
+      outstream1 << "\"input\": " << stages[i].input << ", \"input_unit\": \"" << stages[i].unit << "\", ";
+      outstream1 << "\"output\": " << stages[i].output << ", ";
+      outstream1 << fixed << setprecision(1) << "\"throughput_per_second\": " << throughput << "}";
+      outstream1 << (i+1<long(stages.size()) ? ",\n" : "\n");
+    }
+    outstream1 << "      ]\n";
+    outstream1 << "    }" << (scalect+1<long(scales.size()) ? ",\n" : "\n");
+    outstream1.flush();
+  }
+  outstream1 << "  ]\n";
+  outstream1 << "}\n";
+  outstream1.close();
+  cout << "\nWrote benchmark results to " << outfile << "\n";
+  if(profilefile.size()>0) hlprof_write(profilefile, "heliolinx_bench");
+  return(0);
+}
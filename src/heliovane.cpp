@@ -13,7 +13,7 @@
 
 static void show_usage()
 {
-  cerr << "Usage: heliovane -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliolon heliocentric_longitude_hypothesis_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -minsunelong minimum_solar_elongation(deg) -maxsunelong maximum_solar_elongation(deg) -min_incid_angle min_angle_of_incidence_between_observer_to_target_vector_and_heliocentric_vane(deg) -maxheliodist maximum_heliocentric_radius(AU) -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf -outsum summary_file -clust2det clust2detfile -verbose verbosity\n";
+  cerr << "Usage: heliovane -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -mjd mjdref -autorun 1=yes_auto-generate_MJDref -obspos observer_position_file -heliolon heliocentric_longitude_hypothesis_file -clustrad clustrad -clustchangerad min_distance_for_cluster_scaling -npt dbscan_npt -minobsnights minobsnights -mintimespan mintimespan -mingeodist minimum_geocentric_distance -maxgeodist maximum_geocentric_distance -geologstep logarithmic_step_size_for_geocentric_distance_bins -minsunelong minimum_solar_elongation(deg) -maxsunelong maximum_solar_elongation(deg) -min_incid_angle min_angle_of_incidence_between_observer_to_target_vector_and_heliocentric_vane(deg) -maxheliodist maximum_heliocentric_radius(AU) -mingeoobs min_geocentric_dist_at_observation(AU) -minimpactpar min_impact_parameter(km) -useunivar 1_for_univar_0_for_fgfunc -vinf max_v_inf -outsum summary_file -clust2det clust2detfile -verbose verbosity -profile profile_file\n";
   cerr << "\nor, at minimum:\n\n";
   cerr << "heliovane -imgs imfile -pairdets paired detection file -tracklets tracklet file -trk2det tracklet-to-detection file -obspos observer_position_file -heliolon heliocentric_longitude_hypothesis_file\n";
   cerr << "\nNote that the minimum invocation leaves some things set to defaults\n";
@@ -23,6 +23,7 @@ static void show_usage()
     
 int main(int argc, char *argv[])
 {
+  string profilefile;
   vector <hldet> detvec = {};
   vector <hldet> pairdets = {};
   vector <hlimage> image_log;
@@ -383,11 +384,27 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
   if(config.minobsnights > config.dbscan_npt) config.minobsnights = config.dbscan_npt; // Otherwise the low setting of dbscan_npt is not operative.
 
 
@@ -562,9 +579,9 @@ int main(int argc, char *argv[])
   }
   cout << "Read " << trk2det.size() << " data lines from trk2det file " << trk2detfile << "\n";
   
-  status=heliovane_alg_all(image_log, detvec, tracklets, trk2det, lambdahyp, earthpos, config, outclust, clust2det);
+  status=heliovane_alg_ompdanby(image_log, detvec, tracklets, trk2det, lambdahyp, earthpos, config, outclust, clust2det);
   if(status!=0) {
-    cerr << "ERROR: heliovane_alg_danby failed with status " << status << "\n";
+    cerr << "ERROR: heliovane_alg_ompdanby failed with status " << status << "\n";
     return(status);
   } 
   
@@ -591,5 +608,6 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "heliovane");
   return(0);
 }
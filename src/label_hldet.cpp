@@ -12,6 +12,12 @@
 // is guaranteed to have the same number of lines as the
 // input 'unlabeled' file, and the same string ID's except
 // where matches were found.
+//
+// October 18, 2026: The queries are now run in parallel by
+// crossmatch_4d_index, sharded by time window and sky region
+// so that consecutive queries hit the same parts of the tree.
+// With -chunk N, the labeling file is streamed N lines at a
+// time rather than being read into memory all at once.
 
 #define DAY_TO_DEG_CONV 24.0 // Treats one day as equivalent to 24 degrees:
                              // in other words, one second of time is
@@ -30,16 +36,20 @@
 #define RA_LABCOL 3
 #define DEC_LABCOL 4
 #define COLS_TO_READ2 4
+#define TIMEWIN_DEFAULT 1.0 // Width in days of the time shards used to batch the queries
+#define SKYCELL_DEFAULT 1.0 // Width in degrees of the sky-region shards
+#define BATCHSIZE_DEFAULT 1024 // Number of queries handed to a thread at a time
 
 #include "solarsyst_dyn_geo01.h"
 #include "cmath"
 static void show_usage()
 {
-  cerr << "Usage: label_hldet -unlabeled unlabeled_file -colformat1 column_format_file1 -label labeling_file -colformat2 column_format_file2 -timeoff time_offset_in_seconds -matchrad match_in_arcsec -timescale day_to_deg_conversion -usenearest usenearest -outfile outfile\n";
+  cerr << "Usage: label_hldet -unlabeled unlabeled_file -colformat1 column_format_file1 -label labeling_file -colformat2 column_format_file2 -timeoff time_offset_in_seconds -matchrad match_in_arcsec -timescale day_to_deg_conversion -usenearest usenearest -timewin shard_time_window_days -skycell shard_sky_cell_deg -batch queries_per_batch -chunk labeling_lines_per_chunk -outfile outfile -profile profile_file\n";
 }
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   ofstream outstream1;
   ifstream instream1;
   string colformatfile1,colformatfile2,stest,idstring;
@@ -61,8 +71,6 @@ int main(int argc, char *argv[])
   long splitpoint=0;
   long index=0;
   long colreadct,lct;
-  long nearest=0;
-  double dist = 0.0;
   int reachedeof = 0;
   int startpoint,endpoint;
   point4d_index onepoint = point4d_index(0,0,0,0,0);
@@ -70,8 +78,13 @@ int main(int argc, char *argv[])
   vector <point4d_index> poolvec;
   KD_point4d_index kdpoint = KD_point4d_index(onepoint,-1,-1,1,0);
   vector <KD_point4d_index> kdvec;
-  vector <long> indexvec;
+  vector <point4d_index> queryvec;
+  vector <long_index> matches;
   vector <double> mjdvec;
+  double timewin = TIMEWIN_DEFAULT;
+  double skycell = SKYCELL_DEFAULT;
+  long batchsize = BATCHSIZE_DEFAULT;
+  long chunksize = 0;
   double mjdref = 0.0;
   int idcol=IDCOL;
   int mjdcol = MJDCOL;
@@ -188,6 +201,50 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-timewin" || string(argv[i]) == "-time_window" || string(argv[i]) == "-twin" || string(argv[i]) == "--timewin" || string(argv[i]) == "--time_window") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	timewin=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Time window keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-skycell" || string(argv[i]) == "-sky_cell" || string(argv[i]) == "-cellsize" || string(argv[i]) == "--skycell" || string(argv[i]) == "--sky_cell") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	skycell=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Sky cell keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-batch" || string(argv[i]) == "-batchsize" || string(argv[i]) == "-batch_size" || string(argv[i]) == "--batch" || string(argv[i]) == "--batchsize") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	batchsize=stol(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Batch size keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-chunk" || string(argv[i]) == "-chunksize" || string(argv[i]) == "-chunk_size" || string(argv[i]) == "--chunk" || string(argv[i]) == "--chunksize") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	chunksize=stol(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Chunk size keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else if(string(argv[i]) == "-outfile" || string(argv[i]) == "-out" || string(argv[i]) == "--outfile") {
       if(i+1 < argc) {
 	//There is still something to read;
@@ -199,11 +256,27 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword " << argv[i] <<"\n";
       i++;
     }
   }
+
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
   cout.precision(17);  
 
   cout << "Input unlabeled file is called " << unlabeled_file << "\n";
@@ -217,6 +290,10 @@ int main(int argc, char *argv[])
   cout << "Matching radius will be " << matchrad << " arcseconds\n";
   cout << "Timescale for converting 1 day of time to equivalent degrees will be " << timescale << "\n";
   cout << "Time offset to be applied to MJD values in the labeling file is " << time_offset << " seconds\n";
+  cout << "Queries will be sharded into time windows of " << timewin << " days and sky cells of " << skycell << " degrees\n";
+  cout << "Each thread will process " << batchsize << " queries at a time\n";
+  if(chunksize>0) cout << "The labeling file will be streamed in chunks of " << chunksize << " lines\n";
+  else cout << "The labeling file will be read in its entirety before cross-matching\n";
   cout << "Output file will be called " << outfile << "\n";
   
   // Read the column formatting file for the unlabeled data
@@ -335,10 +412,40 @@ int main(int argc, char *argv[])
   ulnum = unlabeled_dets.size();
   cout << "Read " << ulnum << " data lines from observation file " << unlabeled_file << "\n";
   
-  // Read input labeling file
+  // Find the median MJD for unlabeled detections
+  mjdvec = {};
+  for(ulct=0;ulct<ulnum;ulct++) mjdvec.push_back(unlabeled_dets[ulct].MJD);
+  mjdref = dmedian(mjdvec);
+  cout << "Median MJD of unlabled detections is " << mjdref << "\n";
+  
+  // Load pool of unlabeled sources
+  poolvec = {};
+  for(ulct=0;ulct<ulnum;ulct++) {
+    // Note that timescale is supposed to indicate the number of
+    // degrees on the sky that is the equivalent of one calendar day.
+    // Then, since the trigonometric projection of sky-angles converts
+    // degrees into radians, it is also necessary to divide the
+    // time-quantity by DEGPRAD.
+    onepoint = point4d_index((unlabeled_dets[ulct].MJD-mjdref)*timescale/DEGPRAD,cos(unlabeled_dets[ulct].RA/DEGPRAD)*cos(unlabeled_dets[ulct].Dec/DEGPRAD),sin(unlabeled_dets[ulct].RA/DEGPRAD)*cos(unlabeled_dets[ulct].Dec/DEGPRAD), sin(unlabeled_dets[ulct].Dec/DEGPRAD), ulct);
+    poolvec.push_back(onepoint);
+  }
+  cout << "Finished loading pool of unlabeled sources\n";
+  // Form KDtree
+  kdvec={};
+  kdroot = splitpoint = 0;
+  splitpoint=medind_4d_index(poolvec,1);
+  kdpoint = KD_point4d_index(poolvec[splitpoint],-1,-1,1,0);
+  kdvec.push_back(kdpoint);
+  kdtree_4d_index(poolvec,1,splitpoint,kdroot,kdvec);
+  cout << "Finished constructing k-d tree sources\n";
+  poolvec = {};
+
+  // Read input labeling file. If chunksize>0, only chunksize lines
+  // are held in memory at once: each chunk is cross-matched against
+  // the k-d tree as soon as it has been read, and then discarded.
   labeling_MJD = labeling_RA = labeling_Dec = {};
   labeling_ID = {};
-  lct=0;
+  lct=labnum=0;
   instream1.open(labeling_file);
   if(!instream1) {
     cerr << "can't open input file " << labeling_file << "\n";
@@ -389,22 +496,22 @@ int main(int argc, char *argv[])
     }
     if(reachedeof == 0 && lnfromfile.size()>=15) {
       if(MJD==0.0) {
-	cerr << "ERROR: MJD not read from line " << labeling_MJD.size()+1 << " of input labeling file " << labeling_file << "!\n";
+	cerr << "ERROR: MJD not read from line " << labnum+labeling_MJD.size()+1 << " of input labeling file " << labeling_file << "!\n";
 	cerr << "Here is the line: " << lnfromfile << "\n";
 	return(2);
       }
       if(RA==-999.9) {
-	cerr << "ERROR: RA not read from line " << labeling_RA.size()+1 << " of input labeling file " << labeling_file << "!\n";
+	cerr << "ERROR: RA not read from line " << labnum+labeling_RA.size()+1 << " of input labeling file " << labeling_file << "!\n";
 	cerr << "Here is the line: " << lnfromfile << "\n";
 	return(2);
       }
       if(Dec==-999.9) {
-	cerr << "ERROR: Dec not read from line " << labeling_Dec.size()+1 << " of input labeling file " << labeling_file << "!\n";
+	cerr << "ERROR: Dec not read from line " << labnum+labeling_Dec.size()+1 << " of input labeling file " << labeling_file << "!\n";
 	cerr << "Here is the line: " << lnfromfile << "\n";
 	return(2);
       }
       if(idstring.size()<=0) {
-	cerr << "ERROR: Object ID not read from line " << labeling_ID.size()+1 << " of input labeling file " << labeling_file << "!\n";
+	cerr << "ERROR: Object ID not read from line " << labnum+labeling_ID.size()+1 << " of input labeling file " << labeling_file << "!\n";
 	cerr << "Here is the line: " << lnfromfile << "\n";
 	return(2);
       }
@@ -414,6 +521,39 @@ int main(int argc, char *argv[])
       labeling_ID.push_back(idstring);
       //cout << "MJD, lengths: " << MJD << " " << RA << " " << Dec << " " << idstring << " " << labeling_MJD.size() << " " << labeling_RA.size() << " " << labeling_Dec.size() << " " << labeling_ID.size() << "\n";
     }
+    if(labeling_MJD.size()>0 && (reachedeof==1 || (chunksize>0 && long(labeling_MJD.size())>=chunksize))) {
+      // Cross-match the current chunk of labeling points
+      // against the unlabeled k-d tree.
+      labct = labeling_MJD.size();
+      if(labct != long(labeling_RA.size()) || labct != long(labeling_Dec.size()) || labct != long(labeling_ID.size())) {
+	cerr << "ERROR: length mismatch in vectors read from labeling file: " << labct << " " << labeling_RA.size() << " " << labeling_Dec.size() << " " << labeling_ID.size() << "\n";
+	return(1);
+      }
+      queryvec = {};
+      for(labct=0;labct<long(labeling_MJD.size());labct++) {
+	querypoint = point4d_index((labeling_MJD[labct]-mjdref)*timescale/DEGPRAD,cos(labeling_RA[labct]/DEGPRAD)*cos(labeling_Dec[labct]/DEGPRAD),sin(labeling_RA[labct]/DEGPRAD)*cos(labeling_Dec[labct]/DEGPRAD), sin(labeling_Dec[labct]/DEGPRAD), labct);
+	queryvec.push_back(querypoint);
+      }
+      status = crossmatch_4d_index(kdvec, queryvec, matchrad/ASECPRAD, usenearest, timewin*timescale/DEGPRAD, skycell/DEGPRAD, batchsize, matches, verbose);
+      if(status!=0) {
+	cerr << "ERROR: crossmatch_4d_index failed with status " << status << "\n";
+	return(status);
+      }
+      // Apply the labels. The matches are sorted by labeling index,
+      // so later labeling points supercede earlier ones exactly as
+      // in a serial loop.
+      for(i=0;i<long(matches.size());i++) {
+	index = matches[i].index;
+	stringncopy01(unlabeled_dets[index].idstring,labeling_ID[matches[i].lelem],SHORTSTRINGLEN);
+	unlabeled_dets[index].known_obj=999;
+      }
+      labnum += labeling_MJD.size();
+      cout << "Cross-matched " << labnum << " labeling points, " << matches.size() << " matches in the latest chunk\n";
+      labeling_MJD = labeling_RA = labeling_Dec = {};
+      labeling_ID = {};
+      queryvec = {};
+      matches = {};
+    }
   }
   instream1.close();
   
@@ -430,69 +570,7 @@ int main(int argc, char *argv[])
     return(2);
   }
 
-  labnum = labeling_MJD.size();
-  if(labnum != long(labeling_RA.size()) || labnum != long(labeling_Dec.size()) || labnum != long(labeling_ID.size())) {
-    cerr << "ERROR: length mismatch in vectors read from labeling file: " << labnum << " " << labeling_RA.size() << " " << labeling_Dec.size() << " " << labeling_ID.size() << "\n";
-  }
-  cout << "Read " << labnum << " data lines from observation file " << labeling_file << "\n";
-
-  // Find the median MJD for unlabeled detections
-  mjdvec = {};
-  for(ulct=0;ulct<ulnum;ulct++) mjdvec.push_back(unlabeled_dets[ulct].MJD);
-  mjdref = dmedian(mjdvec);
-  cout << "Median MJD of unlabled detections is " << mjdref << "\n";
-  
-  // Load pool of unlabeled sources
-  poolvec = {};
-  for(ulct=0;ulct<ulnum;ulct++) {
-    // Note that timescale is supposed to indicate the number of
-    // degrees on the sky that is the equivalent of one calendar day.
-    // Then, since the trigonometric projection of sky-angles converts
-    // degrees into radians, it is also necessary to divide the
-    // time-quantity by DEGPRAD.
-    onepoint = point4d_index((unlabeled_dets[ulct].MJD-mjdref)*timescale/DEGPRAD,cos(unlabeled_dets[ulct].RA/DEGPRAD)*cos(unlabeled_dets[ulct].Dec/DEGPRAD),sin(unlabeled_dets[ulct].RA/DEGPRAD)*cos(unlabeled_dets[ulct].Dec/DEGPRAD), sin(unlabeled_dets[ulct].Dec/DEGPRAD), ulct);
-    poolvec.push_back(onepoint);
-  }
-  cout << "Finished loading pool of unlabeled sources\n";
-  // Form KDtree
-  kdvec={};
-  kdroot = splitpoint = 0;
-  splitpoint=medind_4d_index(poolvec,1);
-  kdpoint = KD_point4d_index(poolvec[splitpoint],-1,-1,1,0);
-  kdvec.push_back(kdpoint);
-  kdtree_4d_index(poolvec,1,splitpoint,kdroot,kdvec);
-  cout << "Finished constructing k-d tree sources\n";
-
-  // Loop over pool of labeled sources, performing a nearest-neighbor
-  // query of the unlabled k-d tree for each of them.
-  for(labct=0;labct<labnum;labct++) {
-    querypoint = point4d_index((labeling_MJD[labct]-mjdref)*timescale/DEGPRAD,cos(labeling_RA[labct]/DEGPRAD)*cos(labeling_Dec[labct]/DEGPRAD),sin(labeling_RA[labct]/DEGPRAD)*cos(labeling_Dec[labct]/DEGPRAD), sin(labeling_Dec[labct]/DEGPRAD), labct);
-    if(usenearest!=1) {
-      indexvec={};
-      status = kdrange_4d_index(kdvec, querypoint, matchrad/ASECPRAD, indexvec);
-      for(i=0;i<long(indexvec.size());i++) {
-	// Label the match with an index that maps all the way back to unlabeled_dets
-	index = kdvec[indexvec[i]].point.index;
-	// Change the label for unlabeled_dets
-	stringncopy01(unlabeled_dets[index].idstring,labeling_ID[labct],SHORTSTRINGLEN);
-	unlabeled_dets[index].known_obj=999;
-      }
-    } else {
-      nearest = kdnearest_4d_index(kdvec, querypoint);
-      dist = ASECPRAD*sqrt(point4d_index_dist2(querypoint, kdvec[nearest].point));
-      if(dist<=matchrad) {
-	// Label the match with an index that maps all the way back to unlabeled_dets
-	index = kdvec[nearest].point.index;
-	// Change the label for unlabeled_dets
-	stringncopy01(unlabeled_dets[index].idstring,labeling_ID[labct],SHORTSTRINGLEN);
-	unlabeled_dets[index].known_obj=999;
-      }
-    }
-    if(labct%1000==0) {
-      cout << "Running query for labeling point " << labct << "\n";
-      //cout << querypoint.t << " " << querypoint.x << " " << querypoint.y << " " << querypoint.z << ", " << indexvec.size() << " matches found\n";
-    }
-  }
+  cout << "Read and cross-matched " << labnum << " data lines from observation file " << labeling_file << "\n";
   
   outstream1.open(outfile);
   outstream1 << "#MJD,RA,Dec,mag,trail_len,trail_PA,sigmag,sig_across,sig_along,image,idstring,band,obscode,known_obj,det_qual,origindex\n";
@@ -508,5 +586,6 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
 
+  if(profilefile.size()>0) hlprof_write(profilefile, "label_hldet");
   return(0);
 }
@@ -20,7 +20,7 @@
 #include "cmath"
 
 #define MAXCLUSTRMS 1.0e5
-#define DEBUG 1
+#define DEBUG 0
 #define ESCAPE_SCALE 0.99L // If the input velocity is above escape velocity, we
                            // scale it down by this amount.
 // New quantities in LinkPurifyConfig that are not in LinkRefineConfig:
@@ -31,11 +31,12 @@
 
 static void show_usage()
 {
-  cerr << "Usage: link_purify_chisq -imgs imfile -pairdet pairdet_file -lflist link_file_list -simptype simplex_type -rejfrac max fraction of points that can be rejected -rejnum max number of points that can be rejected -max_astrom_rms max astrometric RMS (arcsec) -minobsnights min number of distinct nights -minpointnum min number of individual detections -useorbMJD 1=use_orbitMJD_if_available -ptpow point_num_exponent -nightpow night_num_exponent -timepow timespan_exponent -rmspow astrom_rms_exponent -maxrms maxrms -ecc_penalty ecc_penalty -outsum summary_file -clust2det clust2detfile -verbose verbosity\n\nOR, at minimum:\nlink_purify_chisq -imgs imfile -pairdet pairdet_file -lflist link_file_list\n";
+  cerr << "Usage: link_purify_chisq -imgs imfile -pairdet pairdet_file -lflist link_file_list -simptype simplex_type -rejfrac max fraction of points that can be rejected -rejnum max number of points that can be rejected -max_astrom_rms max astrometric RMS (arcsec) -minobsnights min number of distinct nights -minpointnum min number of individual detections -useorbMJD 1=use_orbitMJD_if_available -ptpow point_num_exponent -nightpow night_num_exponent -timepow timespan_exponent -rmspow astrom_rms_exponent -maxrms maxrms -ecc_penalty ecc_penalty -outsum summary_file -clust2det clust2detfile -verbose verbosity -profile profile_file\n\nOR, at minimum:\nlink_purify_chisq -imgs imfile -pairdet pairdet_file -lflist link_file_list\n";
 }
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   string clusterlist;
   string sumfile,clust2detfile;
   vector <hlclust> inclustvec;
@@ -302,12 +303,28 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   // Catch required parameters if missing
   if(imfile.size()<=0) {
     cout << "\nERROR: input image catalog file is required\n";
@@ -488,5 +505,6 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "link_purify_chisq");
   return(0);
 }
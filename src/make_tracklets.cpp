@@ -47,7 +47,9 @@ static void show_usage()
   cerr << "-max_netl maximum number of points for a non-exclusive (overlap permitted) tracklet/ \n";
   cerr << "-time_offset offset in seconds to be added to observations times to get UTC/ \n";
   cerr << "-minvel minimum angular velocity (deg/day) -maxvel maximum angular velocity (deg/day)/ \n";
-  cerr << "-minarc minimum total angular arc (arcsec) -earth earthfile -obscode obscodefile -forcerun\n";
+  cerr << "-minarc minimum total angular arc (arcsec) -earth earthfile -obscode obscodefile -forcerun/ \n";
+  cerr << "-exclude_glints 1 to remove satellite glint trails before pairing -glint_minpts min. points in a glint trail/ \n";
+  cerr << "-glint_maxgcr max. glint trail GCR (arcsec) -glint_maxrange max. glint trail search range (arcsec) -profile profile_file -loglevel 0=errors_only_2=summaries_3=progress_4=verbose_diagnostics\n";
   cerr << "\nor, at minimum\n\n";
   cerr << "make_tracklets -dets detfile -earth earthfile -obscode obscodefile\n";
   cerr << "Note well that the minimum invocation will leave a bunch of things\n";
@@ -57,6 +59,7 @@ static void show_usage()
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   vector <hldet> detvec = {};
   vector <hldet> pairdets = {};
   vector <observatory> observatory_list = {};
@@ -99,6 +102,10 @@ int main(int argc, char *argv[])
   int maxtime_default,mintime_default,minvel_default,maxvel_default,matchrad_default,trkfrac_default;
   int maxgcr_default,minarc_default,mintrkpts_default,time_offset_default,maxnetl_default;
   MakeTrackletsConfig config;
+  FindGlintsConfig glintconfig;
+  int exclude_glints = 0;
+  vector <glint_trail> glinttrails;
+  vector <longpair> glint2det;
   
   outimfile_default = pairdetfile_default = trackletfile_default = trk2detfile_default = imagerad_default = 1;
   maxtime_default = mintime_default = minvel_default = maxvel_default = matchrad_default = trkfrac_default = 1;
@@ -420,6 +427,50 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-exclude_glints" || string(argv[i]) == "-noglints" || string(argv[i]) == "-no_glints" || string(argv[i]) == "-glints" || string(argv[i]) == "--exclude_glints" || string(argv[i]) == "--noglints") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	exclude_glints=stoi(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Glint exclusion keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-glint_minpts" || string(argv[i]) == "-glint_minpoints" || string(argv[i]) == "-glintmpt" || string(argv[i]) == "--glint_minpts" || string(argv[i]) == "--glint_minpoints") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	glintconfig.minpoints=stol(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Glint min. points keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-glint_maxgcr" || string(argv[i]) == "-glint_maxGCR" || string(argv[i]) == "-glintgcr" || string(argv[i]) == "--glint_maxgcr" || string(argv[i]) == "--glint_maxGCR") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	glintconfig.maxgcr=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Glint max. GCR keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-glint_maxrange" || string(argv[i]) == "-glint_range" || string(argv[i]) == "-glintrange" || string(argv[i]) == "--glint_maxrange" || string(argv[i]) == "--glint_range") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	glintconfig.maxrange=stod(argv[++i]);
+	i++;
+      }
+      else {
+	cerr << "Glint max. range keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else if(string(argv[i]) == "-verbose" || string(argv[i]) == "-verb" || string(argv[i]) == "-VERBOSE" || string(argv[i]) == "-VERB" || string(argv[i]) == "--verbose" || string(argv[i]) == "--VERBOSE" || string(argv[i]) == "--VERB") {
       if(i+1 < argc) {
 	//There is still something to read;
@@ -434,12 +485,39 @@ int main(int argc, char *argv[])
     } else if(string(argv[i]) == "-forcerun" || string(argv[i]) == "-force"  || string(argv[i]) == "-fr" || string(argv[i]) == "-f" || string(argv[i]) == "--force" || string(argv[i]) == "--forcerun") {
       config.forcerun=1;
       i++;
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
+    } else if(string(argv[i]) == "-loglevel" || string(argv[i]) == "-log" || string(argv[i]) == "--loglevel" || string(argv[i]) == "--log_level") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	hllog_set_level(stoi(argv[++i]));
+	i++;
+      }
+      else {
+	cerr << "Log level keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword " << argv[i] <<"\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   if(indetfile.size()<=0) {
     cerr << "Please supply an input detection file:\n\n";
     show_usage();
@@ -544,6 +622,9 @@ int main(int argc, char *argv[])
   else cout << "Defaulting to minimum tracklet length = " << config.minarc << " arcsec.\n";
   if(maxgcr_default == 0) cout << "Maximum tracklet Great Circle residual = " << config.maxgcr << " arcsec.\n";
   else cout << "Defulting to maximum tracklet Great Circle residual = " << config.maxgcr << " arcsec.\n";
+  if(exclude_glints>0) {
+    cout << "Satellite glint trails will be excluded before pairing: min. " << glintconfig.minpoints << " points, max. GCR " << glintconfig.maxgcr << " arcsec, search range " << glintconfig.maxrange << " arcsec.\n";
+  } else cout << "Satellite glint trails will not be excluded.\n";
   
   // Read the column formatting file, if any
   if(colformatfile.size()>0)
@@ -671,7 +752,11 @@ int main(int argc, char *argv[])
   if(config.verbose>=1) cout << "Preparing to time-sort the detection vector\n";
   
   //time-sort the detection vector
-  sort(detvec.begin(), detvec.end(), early_hldet());
+  status = sort_hldet_parallel(detvec, IMAGETIMETOL/SOLARDAY);
+  if(status!=0) {
+    cerr << "ERROR: sort_hldet_parallel failed with status " << status << "\n";
+    return(status);
+  }
   
   if(config.verbose>=1) cout << "Time-sorted the detection vector\n";
 
@@ -718,6 +803,16 @@ int main(int argc, char *argv[])
     outstream1.close();
   }
   
+  if(exclude_glints>0) {
+    // Remove satellite glint trails image-by-image, before find_pairs can
+    // turn them into spurious tracklets.
+    status = exclude_glint_dets(detvec, img_log, glintconfig, glinttrails, glint2det, config.verbose);
+    if(status!=0) {
+      cerr << "ERROR: glint exclusion failed with status " << status << "\n";
+      return(status);
+    }
+  }
+  
   // Replace any invalid exposure times with the default (or user-supplied constant) value.
   long exp_resetnum=0;
   for(i=0;i<long(img_log.size());i++) {
@@ -779,6 +874,7 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
 
+  if(profilefile.size()>0) hlprof_write(profilefile, "make_tracklets");
   return(0);
 }
 
@@ -52,7 +52,7 @@ static void show_usage()
   cerr << "-minarc minimum total angular arc (arcsec) -siglenscale fractional trail length matching tolerance/ \n";
   cerr << "-sigpascale trail orientation matching tolerance (arcsec; will be divided by trail length/ \n";
   cerr << "to get matching tolerance in radians) -exptime exposure time (seconds) -earth earthfile/ \n";
-  cerr << "-obscode obscodefile -forcerun\n";
+  cerr << "-obscode obscodefile -forcerun -profile profile_file\n";
   cerr << "\nor, at minimum\n\n";
   cerr << "make_tracklets -dets detfile -earth earthfile -obscode obscodefile\n";
   cerr << "Note well that the minimum invocation will leave a bunch of things\n";
@@ -62,6 +62,7 @@ static void show_usage()
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   vector <hldet> detvec = {};
   vector <hldet> pairdets = {};
   vector <observatory> observatory_list = {};
@@ -437,12 +438,28 @@ int main(int argc, char *argv[])
     } else if(string(argv[i]) == "-forcerun" || string(argv[i]) == "-force"  || string(argv[i]) == "-fr" || string(argv[i]) == "-f" || string(argv[i]) == "--force" || string(argv[i]) == "--forcerun") {
       config.forcerun=1;
       i++;
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword " << argv[i] <<"\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   if(indetfile.size()<=0) {
     cerr << "Please supply an input detection file:\n\n";
     show_usage();
@@ -634,7 +651,11 @@ int main(int argc, char *argv[])
   if(DEBUGB==1) cout << "Preparing to time-sort the detection vector\n";
   
   // time-sort the detection vector
-  sort(detvec.begin(), detvec.end(), early_hldet());
+  status = sort_hldet_parallel(detvec, IMAGETIMETOL/SOLARDAY);
+  if(status!=0) {
+    cerr << "ERROR: sort_hldet_parallel failed with status " << status << "\n";
+    return(status);
+  }
   
   if(DEBUGB==1) cout << "Time-sorted the detection vector\n";
 
@@ -733,6 +754,7 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
 
+  if(profilefile.size()>0) hlprof_write(profilefile, "make_trailed_tracklets");
   return(0);
 }
 
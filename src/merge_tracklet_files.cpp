@@ -11,60 +11,97 @@
 // new, expanded set of images, and the indices in the trk2det file
 // have to be changed to reflect the new, expanded set of paired
 // detections.
+//
+// October 18, 2026: Rather than folding the input file sets into
+// the master vectors one at a time, which re-sorted and re-de-duplicated
+// the entire master set for each new input and hence took time roughly
+// quadratic in the number of inputs, all the input sets are now read
+// at once (in parallel) and merged in a single pass: a k-way merge of the
+// time-sorted image catalogs, followed by one sort and de-duplication of
+// the concatenated paired detections. This produces remapping tables from
+// each input image and detection to its merged counterpart, which are then
+// applied to the tracklet and trk2det files. The image startind and endind
+// values are recalculated for the merged paired detection catalog, and
+// the four output files are written in parallel.
 
 #include "solarsyst_dyn_geo01.h"
 #include "cmath"
+#include <queue>
 
-#define MAXCOMB 100
 #define ARCSEC_MATCHTOL 0.1
-#define NEG_MJD_MARK -999999999.9
+
+class imgsort_hldet_index{ // Sort indices to a vector of hldet
+                           // as imgsort_hldet would sort the hldets.
+public:
+  const vector <hldet> &dets;
+  imgsort_hldet_index(const vector <hldet> &dets) :dets(dets) {}
+  inline bool operator() (long i1, long i2) {
+    return(imgsort_hldet()(dets[i1],dets[i2]));
+  }
+};
+
+class later_double_index{ // For a priority queue yielding the smallest delem first.
+public:
+  inline bool operator() (const double_index& i1, const double_index& i2) {
+    return(i1.delem > i2.delem);
+  }
+};
 
 static void show_usage()
 {
-  cerr << "Usage: merge_tracklet_files -inlist input_file_list -outputs output_image file output_paired_detection_file output_tracklet_file output_tracklet-to-detection_file -matchtol detection_match_tol_arcsec\n";
+  cerr << "Usage: merge_tracklet_files -inlist input_file_list -outputs output_image file output_paired_detection_file output_tracklet_file output_tracklet-to-detection_file -matchtol detection_match_tol_arcsec -profile profile_file\n";
 }
     
 int main(int argc, char *argv[])
 {
+  string profilefile;
   string inlist;
-  string in_image_files[MAXCOMB], in_pairdet_files[MAXCOMB];
-  string in_tracklet_files[MAXCOMB], in_trk2det_files[MAXCOMB];
+  vector <string> in_image_files, in_pairdet_files;
+  vector <string> in_tracklet_files, in_trk2det_files;
   string imagefile,pairdetfile,trackletfile,trk2detfile;
   string imagefile_out,pairdetfile_out,trackletfile_out,trk2detfile_out;
-  vector <hlimage> inimage;
-  vector <hldet> inpairdets;
+  vector <vector <hlimage>> inimages;
+  vector <vector <hldet>> inpairdets;
+  vector <vector <tracklet>> intracklets_all;
+  vector <vector <longpair>> intrk2det_all;
+  vector <int> readstatus;
   vector <tracklet> intracklets;
   vector <longpair> intrk2det;
   vector <long_index> tracklet_hash;
   vector <hlimage> masterimage;
-  vector <hlimage> tempimage;
+  vector <hldet> alldets;
   vector <hldet> masterpairdets;
-  vector <hldet> temppairdets;
-  vector <hldet> oldpairdets;
   vector <tracklet> mastertracklets;
   vector <longpair> master_trk2det;
+  vector <vector <long>> in_imindex;
+  vector <long> detoffset;
+  vector <long> detorder;
+  vector <long> matchcount;
+  vector <long> detrep;
+  vector <long> newdetindex;
+  vector <long> detmap;
+  vector <long_index> partnervec;
+  vector <long> imct;
+  priority_queue <double_index, vector <double_index>, later_double_index> imqueue;
   int verbose=0;
   ofstream outstream1;
-  int status=0;
   ifstream instream1;
-  int filenum,filect,tmpim;
-  filenum = filect = tmpim = 0;
-  vector <long> temp_imindex;
-  vector <long> in_imindex;
-  vector <long> in_detindex;
-  vector <long> old_detindex;
-  long masterimnum,inimnum,tempimnum,masterimct,inimct,tempimct;
-  masterimnum = inimnum = tempimnum = masterimct = inimct = tempimct = 0;
+  int filenum,filect;
+  filenum = filect = 0;
+  long masterimnum,inimct,masterimct;
+  masterimnum = inimct = masterimct = 0;
   int matchfound=0;
-  long masterdetnum,indetnum,olddetnum,detct,i,j;
-  masterdetnum = indetnum = olddetnum = detct = i = j = 0;
-  long master_trknum,in_trknum,trkct;
+  long masterdetnum,detnum,detct,i,j;
+  masterdetnum = detnum = detct = i = j = 0;
+  long master_trknum,trkct;
+  master_trknum = trkct = 0;
   long_index one_lindex = long_index(0,0);
-  vector <long_index> partnervec;
+  double_index one_dindex = double_index(0.0l,0);
   double arcsec_matchtol = ARCSEC_MATCHTOL;
   double deg_matchtol = arcsec_matchtol/3600.0;
   vector <long> trkvec;
   longpair onepair = longpair(0,0);
+  tracklet onetrk = tracklet(0,0.0l,0.0l,0,0.0l,0.0l,0,0);
   
   if(argc!=8 && argc!=10) {
     cout << "Need argc=8 or 10, got " << argc << "\n";
@@ -112,18 +149,33 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   instream1.open(inlist);
   if(!instream1) {
     cerr << "can't open input file " << inlist << "\n";
     return(1);
   }
-  filect=0;
   while(!instream1.eof() && !instream1.fail() && !instream1.bad()) {
     imagefile = pairdetfile = trackletfile = trk2detfile = "";
     instream1 >> imagefile;
@@ -131,381 +183,221 @@ int main(int argc, char *argv[])
     instream1 >> trackletfile;
     instream1 >> trk2detfile;
     if(imagefile.size()>0 && pairdetfile.size()>0 && trackletfile.size()>0 && trk2detfile.size()>0) {
-      in_image_files[filect] = imagefile;
-      in_pairdet_files[filect] = pairdetfile;
-      in_tracklet_files[filect] = trackletfile;
-      in_trk2det_files[filect] = trk2detfile;
-      filect++;
+      in_image_files.push_back(imagefile);
+      in_pairdet_files.push_back(pairdetfile);
+      in_tracklet_files.push_back(trackletfile);
+      in_trk2det_files.push_back(trk2detfile);
     }
   }
-  filenum = filect;
+  filenum = in_image_files.size();
   cout << "Read " << filenum << " lines from input file list " << inlist << "\n";
   instream1.close();
-    
-  // Read first set of input files into the master vectors
-  masterimage={};
-  status=read_image_file2(in_image_files[0], masterimage);
-  if(status!=0) {
-    cerr << "ERROR: could not successfully read image file " << in_image_files[0] << "\n";
-    cerr << "read_image_file2 returned status = " << status << ".\n";
-   return(1);
-  }
-  cout << "Read " << masterimage.size() << " data lines from image file " << in_image_files[0] << "\n";
-  masterpairdets={};
-  status=read_pairdet_file(in_pairdet_files[0], masterpairdets , verbose);
-  if(status!=0) {
-    cerr << "ERROR: could not successfully read paired detection file " << in_pairdet_files[0] << "\n";
-    cerr << "read_pairdet_file returned status = " << status << ".\n";
-   return(1);
-  }
-  cout << "Read " << masterpairdets.size() << " data lines from paired detection file " << in_pairdet_files[0] << "\n";
-  mastertracklets={};
-  status=read_tracklet_file(in_tracklet_files[0], mastertracklets, verbose);
-  if(status!=0) {
-    cerr << "ERROR: could not successfully read tracklet file " << in_tracklet_files[0] << "\n";
-    cerr << "read_tracklet_file returned status = " << status << ".\n";
-   return(1);
-  }
-  cout << "Read " << mastertracklets.size() << " data lines from tracklet file " << in_tracklet_files[0] << "\n";
-  master_trk2det={};
-  status=read_longpair_file(in_trk2det_files[0], master_trk2det, verbose);
-  if(status!=0) {
-    cerr << "ERROR: could not successfully read trk2det file " << in_trk2det_files[0] << "\n";
-    cerr << "read_longpair_file returned status = " << status << ".\n";
-   return(1);
+  if(filenum<=0) {
+    cerr << "ERROR: no input file sets found in " << inlist << "\n";
+    return(1);
   }
-  cout << "Read " << master_trk2det.size() << " data lines from trk2det file " << in_trk2det_files[0] << "\n";
 
-  // Loop over remaining file sets
-  for(filect=1;filect<filenum;filect++) {
-    inimage={};
-    status=read_image_file2(in_image_files[filect], inimage);
-    if(status!=0) {
+  // Read all of the input file sets, in parallel
+  inimages = vector <vector <hlimage>> (filenum);
+  inpairdets = vector <vector <hldet>> (filenum);
+  intracklets_all = vector <vector <tracklet>> (filenum);
+  intrk2det_all = vector <vector <longpair>> (filenum);
+  readstatus = vector <int> (filenum,0);
+  #pragma omp parallel for schedule(dynamic)
+  for(int fct=0; fct<filenum; fct++) {
+    if(read_image_file2(in_image_files[fct], inimages[fct])!=0) readstatus[fct]=1;
+    else if(read_pairdet_file(in_pairdet_files[fct], inpairdets[fct], verbose)!=0) readstatus[fct]=2;
+    else if(read_tracklet_file(in_tracklet_files[fct], intracklets_all[fct], verbose)!=0) readstatus[fct]=3;
+    else if(read_longpair_file(in_trk2det_files[fct], intrk2det_all[fct], verbose)!=0) readstatus[fct]=4;
+  }
+  for(filect=0;filect<filenum;filect++) {
+    if(readstatus[filect]==1) {
       cerr << "ERROR: could not successfully read image file " << in_image_files[filect] << "\n";
-      cerr << "read_image_file2 returned status = " << status << ".\n";
       return(1);
-    }
-    cout << "Read " << inimage.size() << " data lines from image file " << in_image_files[filect] << "\n";
-    inpairdets={};
-    status=read_pairdet_file(in_pairdet_files[filect], inpairdets, verbose);
-    if(status!=0) {
+    } else if(readstatus[filect]==2) {
       cerr << "ERROR: could not successfully read paired detection file " << in_pairdet_files[filect] << "\n";
-      cerr << "read_pairdet_file returned status = " << status << ".\n";
       return(1);
-    }
-    cout << "Read " << inpairdets.size() << " data lines from paired detection file " << in_pairdet_files[filect] << "\n";
-    intracklets={};
-    status=read_tracklet_file(in_tracklet_files[filect], intracklets, verbose);
-    if(status!=0) {
+    } else if(readstatus[filect]==3) {
       cerr << "ERROR: could not successfully read tracklet file " << in_tracklet_files[filect] << "\n";
-      cerr << "read_tracklet_file returned status = " << status << ".\n";
       return(1);
-    }
-    cout << "Read " << intracklets.size() << " data lines from tracklet file " << in_tracklet_files[filect] << "\n";
-    intrk2det={};
-    status=read_longpair_file(in_trk2det_files[filect], intrk2det, verbose);
-    if(status!=0) {
+    } else if(readstatus[filect]==4) {
       cerr << "ERROR: could not successfully read trk2det file " << in_trk2det_files[filect] << "\n";
-      cerr << "read_longpair_file returned status = " << status << ".\n";
       return(1);
     }
-    cout << "Read " << intrk2det.size() << " data lines from trk2det file " << in_trk2det_files[filect] << "\n";
-    // Copy masterimage into tempimage
-    tempimage = masterimage;
-    inimnum = inimage.size();
-    tempimnum = tempimage.size();
-    make_lvec(masterimnum, temp_imindex);
-    make_lvec(inimnum, in_imindex);
-    // Concatenate the new image catalog
-    for(i=0;i<inimnum;i++) masterimage.push_back(inimage[i]);
-    // Sort the concatenated catalog
-    sort(masterimage.begin(), masterimage.end(), early_hlimage());
-    // De-duplicate the masterimage vector
-    cout << "Master image set has " << masterimage.size() << " images prior to de-duplication\n";
-    i=1;
-    while(i<long(masterimage.size()) && masterimage.size()>0) {
-      j=i-1;
-      int deleted_one = 0;
-      while(masterimage[j].MJD >= masterimage[i].MJD-IMAGETIMETOL/SOLARDAY && j>=0) {
-	if(fabs(masterimage[i].MJD - masterimage[j].MJD)<IMAGETIMETOL/SOLARDAY && stringnmatch01(masterimage[i].obscode,masterimage[j].obscode,3)==0) {
-	  // Image i is a duplicate of image j. Erase image i from the vector
-	  cout << "Image " << i << " with MJD and obscode " << masterimage[i].MJD << " " << masterimage[i].obscode << " is a duplicate of image " << j << ": " << masterimage[j].MJD << " " << masterimage[j].obscode << "\n";
-	  masterimage.erase(masterimage.begin()+i);
-	  deleted_one=1;
-	  break;
-	} else j--;
-      }
-      if(!deleted_one) i++;
-    }
-    masterimnum = masterimage.size();
-    cout << "Master image set has " << masterimnum << " images after de-duplication\n";
+    cout << "File set " << filect << ": read " << inimages[filect].size() << " images, " << inpairdets[filect].size() << " paired detections, " << intracklets_all[filect].size() << " tracklets, and " << intrk2det_all[filect].size() << " trk2det entries\n";
+  }
 
-    // Load index vector connecting the old masterimage vector with the new
-    masterimct=0;
-    tempimct=0;
-    make_lvec(tempimnum, temp_imindex);
-    for(tempimct=0;tempimct<tempimnum;tempimct++) {
-      // Find a match for tempimage[tempimct] in the master image vector
-      // Go backwards through masterimage until we are certain to be before tempimage[tempimct]
-      while(masterimct>0 && masterimage[masterimct].MJD >= tempimage[tempimct].MJD - IMAGETIMETOL/SOLARDAY) masterimct--;
-      // Now go forward until we find a match
-      matchfound=0;
-      while(masterimct<masterimnum && masterimage[masterimct].MJD <= tempimage[tempimct].MJD + IMAGETIMETOL/SOLARDAY) {
-	if(fabs(tempimage[tempimct].MJD - masterimage[masterimct].MJD)<IMAGETIMETOL/SOLARDAY && stringnmatch01(tempimage[tempimct].obscode, masterimage[masterimct].obscode,3)==0) {
-	  matchfound=1;
-	  temp_imindex[tempimct] = masterimct;
-	  break;
-	}
-	masterimct++;
-      }
-      if(!matchfound) {
-	cerr << "ERROR: no match found to image " << tempimct << " " << tempimage[tempimct].MJD << " " << tempimage[tempimct].RA << " " << tempimage[tempimct].Dec << " " << tempimage[tempimct].obscode << "\n";
-	return(3);
-      }
+  // MERGE THE IMAGE CATALOGS
+  // Sort each image catalog by time. Normally they will already be
+  // time-sorted, but we don't rely on it.
+  vector <vector <double_index>> imsort(filenum);
+  for(filect=0;filect<filenum;filect++) {
+    for(inimct=0;inimct<long(inimages[filect].size());inimct++) {
+      one_dindex = double_index(inimages[filect][inimct].MJD,inimct);
+      imsort[filect].push_back(one_dindex);
     }
-    cout << "Created index-matching vector for tempimage to masterimage\n";
-    masterimct=0;
-    inimct=0;
-    make_lvec(inimnum, in_imindex);
-    for(inimct=0;inimct<inimnum;inimct++) {
-      // Find a match for inimage[inimct] in the master image vector
-      // Go backwards through masterimage until we are certain to be before inimage[inimct]
-      while(masterimct>0 && masterimage[masterimct].MJD >= inimage[inimct].MJD - IMAGETIMETOL/SOLARDAY) masterimct--;
-      // Now go forward until we find a match
-      matchfound=0;
-      while(masterimct<masterimnum && masterimage[masterimct].MJD <= inimage[inimct].MJD + IMAGETIMETOL/SOLARDAY) {
-	if(fabs(inimage[inimct].MJD - masterimage[masterimct].MJD)<IMAGETIMETOL/SOLARDAY && stringnmatch01(inimage[inimct].obscode, masterimage[masterimct].obscode,3)==0) {
-	  matchfound=1;
-	  in_imindex[inimct] = masterimct;
-	  break;
-	}
-	masterimct++;
-      }
-      if(!matchfound) {
-	cerr << "ERROR: no match found to image " << inimct << " " << inimage[inimct].MJD << " " << inimage[inimct].RA << " " << inimage[inimct].Dec << " " << inimage[inimct].obscode << "\n";
-	return(3);
+    stable_sort(imsort[filect].begin(), imsort[filect].end(), lower_double_index());
+    in_imindex.push_back(vector <long> (inimages[filect].size(),-1));
+  }
+  // k-way merge: the priority queue holds the next image from each input
+  // catalog, with the index of the catalog, so the earliest image overall
+  // is always at the top. Each image is compared to images already in the
+  // merged catalog within IMAGETIMETOL, and is either identified as a
+  // duplicate or appended.
+  imct = vector <long> (filenum,0);
+  for(filect=0;filect<filenum;filect++) {
+    if(imsort[filect].size()>0) imqueue.push(double_index(imsort[filect][0].delem,filect));
+  }
+  masterimage={};
+  while(!imqueue.empty()) {
+    filect = imqueue.top().index;
+    imqueue.pop();
+    inimct = imsort[filect][imct[filect]].index;
+    const hlimage &inim = inimages[filect][inimct];
+    matchfound=0;
+    masterimct = masterimage.size()-1;
+    while(masterimct>=0 && masterimage[masterimct].MJD >= inim.MJD-IMAGETIMETOL/SOLARDAY) {
+      if(fabs(inim.MJD - masterimage[masterimct].MJD)<IMAGETIMETOL/SOLARDAY && stringnmatch01(inim.obscode,masterimage[masterimct].obscode,3)==0) {
+	matchfound=1;
+	break;
       }
+      masterimct--;
     }
-    cout << "Created index-matching vector for inimage to masterimage\n";
-    // Update the image indices in the old pairdets file
-    masterdetnum = masterpairdets.size();
-    for(detct=0;detct<masterdetnum;detct++) {
-      tmpim = masterpairdets[detct].image;
-      masterpairdets[detct].image = temp_imindex[tmpim];
-    }
-    // Update the image indices in the latest input pairdets file
-    indetnum = inpairdets.size();
-    for(detct=0;detct<indetnum;detct++) {
-      tmpim = inpairdets[detct].image;
-      inpairdets[detct].image = in_imindex[tmpim];
-    }
-    // Update the image indices in the tracklet files
-    master_trknum = mastertracklets.size();
-    for(trkct=0;trkct<master_trknum;trkct++) {
-      tmpim = mastertracklets[trkct].Img1;
-      mastertracklets[trkct].Img1 = temp_imindex[tmpim];
-      tmpim = mastertracklets[trkct].Img2;
-      mastertracklets[trkct].Img2 = temp_imindex[tmpim];
-    }
-    in_trknum = intracklets.size();
-    for(trkct=0;trkct<in_trknum;trkct++) {
-      tmpim = intracklets[trkct].Img1;
-      intracklets[trkct].Img1 = in_imindex[tmpim];
-      tmpim = intracklets[trkct].Img2;
-      intracklets[trkct].Img2 = in_imindex[tmpim];
+    if(matchfound) {
+      if(verbose>=1) cout << "Image " << inimct << " of file set " << filect << ", with MJD and obscode " << inim.MJD << " " << inim.obscode << ", is a duplicate of merged image " << masterimct << "\n";
+      in_imindex[filect][inimct] = masterimct;
+    } else {
+      in_imindex[filect][inimct] = masterimage.size();
+      masterimage.push_back(inim);
     }
+    imct[filect]++;
+    if(imct[filect]<long(imsort[filect].size())) imqueue.push(double_index(imsort[filect][imct[filect]].delem,filect));
+  }
+  masterimnum = masterimage.size();
+  cout << "Merged image catalog has " << masterimnum << " images after de-duplication\n";
 
-    // Concatenate the pairdets files
-    oldpairdets = temppairdets = masterpairdets;
-    olddetnum = oldpairdets.size();
-    indetnum = inpairdets.size();
-    for(detct=0;detct<indetnum;detct++) temppairdets.push_back(inpairdets[detct]);
-    // Sort temppairdets by image (then Dec, then RA)
-    sort(temppairdets.begin(), temppairdets.end(), imgsort_hldet());
-    partnervec = {};
-    i=0;
-    for(detct=0;detct<long(temppairdets.size());detct++) {
-      // Decrement i until we are certain to be below any duplicates
-      while(i>0 && (temppairdets[i].image > temppairdets[detct].image || (temppairdets[i].image == temppairdets[detct].image && temppairdets[i].Dec >= temppairdets[detct].Dec - deg_matchtol))) i--;
-      long matchnum=0;
-      // Find all possible duplicates for temppairdets[detct]
-      while(i<long(temppairdets.size()) && (temppairdets[i].image < temppairdets[detct].image || (temppairdets[i].image == temppairdets[detct].image && temppairdets[i].Dec <= temppairdets[detct].Dec + deg_matchtol))) {
-	if(i==detct) matchnum++;
-	else if(temppairdets[i].image == temppairdets[detct].image) {
-	  // Calculate the distance from detection i to detection detct
-	  double dist =  distradec01(temppairdets[detct].RA, temppairdets[detct].Dec, temppairdets[i].RA, temppairdets[i].Dec);
-	  if(dist<=deg_matchtol) matchnum++;
-	}
-	i++;
+  // MERGE THE PAIRED DETECTIONS
+  // Concatenate all of the paired detection catalogs, with
+  // image indices mapped into the merged image catalog.
+  alldets={};
+  detoffset={};
+  for(filect=0;filect<filenum;filect++) {
+    detoffset.push_back(alldets.size());
+    for(detct=0;detct<long(inpairdets[filect].size());detct++) {
+      alldets.push_back(inpairdets[filect][detct]);
+      if(alldets.back().image<0 || alldets.back().image>=long(in_imindex[filect].size())) {
+	cerr << "ERROR: detection " << detct << " of file set " << filect << " has out-of-range image index " << alldets.back().image << "\n";
+	return(2);
       }
-      one_lindex = long_index(matchnum,detct);
-      partnervec.push_back(one_lindex);
+      alldets.back().image = in_imindex[filect][alldets.back().image];
     }
-    if(long(partnervec.size()) != long(temppairdets.size())) {
-      cerr << "ERROR: partnervec improperly loaded, size mismatch " << partnervec.size() << " vs. " << temppairdets.size() << "\n";
-      return(2);
+    inpairdets[filect] = {};
+  }
+  detnum = alldets.size();
+  // Sort (indices to) the concatenated detections by image, then Dec, then RA.
+  make_lvec(detnum, detorder);
+  for(detct=0;detct<detnum;detct++) detorder[detct]=detct;
+  sort(detorder.begin(), detorder.end(), imgsort_hldet_index(alldets));
+  // Count the duplicates of each detection, in parallel
+  matchcount = vector <long> (detnum,0);
+  #pragma omp parallel for schedule(dynamic,1000)
+  for(long dct=0; dct<detnum; dct++) {
+    const hldet &det = alldets[detorder[dct]];
+    long matchnum=1;
+    for(long dj=dct-1; dj>=0 && alldets[detorder[dj]].image == det.image && alldets[detorder[dj]].Dec >= det.Dec - deg_matchtol; dj--) {
+      if(distradec01(det.RA, det.Dec, alldets[detorder[dj]].RA, alldets[detorder[dj]].Dec) <= deg_matchtol) matchnum++;
     }
-    // Sort partnervec by number of matches
-    sort(partnervec.begin(), partnervec.end(), lower_long_index());
-    // Loop over temppairdets in order of decreasing numbers of pair-partners,
-    // and load a de-duplicated version into masterpairdets.
-    masterpairdets = {};
-    for(i=partnervec.size()-1 ; i>=0 ; i--) {
-      detct = partnervec[i].index;
-      long matchnum = partnervec[i].lelem;
-      if(matchnum==1 && temppairdets[detct].MJD>=0.0) {
-	// There were no duplicates, and this detection was not previously
-	// marked as a duplicate of some other detection. Load it to masterpairdets.
-	masterpairdets.push_back(temppairdets[detct]);
-      } else if(matchnum>1 && temppairdets[detct].MJD>=0.0) {
-	// This detection was not previously marked as a duplicate of some other
-	// detection, but it has some duplicates. Push back the current (central) one.
-	masterpairdets.push_back(temppairdets[detct]);
-	// Find all possible duplicates for temppairdets[detct], and mark them
-	// as duplicates by setting MJD to NEG_MJD_MARK
-	j=detct;
-	// Decrement j until we are certain to be below any duplicates
-	while(j>0 && (temppairdets[j].image > temppairdets[detct].image || (temppairdets[j].image == temppairdets[detct].image && temppairdets[j].Dec >= temppairdets[detct].Dec - deg_matchtol))) j--;
-	// Search upward through temppairdets until all duplicates have been found
-	while(j<long(temppairdets.size()) && (temppairdets[j].image < temppairdets[detct].image || (temppairdets[j].image == temppairdets[detct].image && temppairdets[j].Dec <= temppairdets[detct].Dec + deg_matchtol))) {
-	  if(j!=detct && temppairdets[j].image == temppairdets[detct].image) {
-	    // Calculate the distance from detection j to detection detct
-	    double dist =  distradec01(temppairdets[detct].RA, temppairdets[detct].Dec, temppairdets[j].RA, temppairdets[j].Dec);
-	    if(dist<=deg_matchtol) temppairdets[j].MJD = NEG_MJD_MARK;
-	  }
-	  j++;
-	}
-      }
+    for(long dj=dct+1; dj<detnum && alldets[detorder[dj]].image == det.image && alldets[detorder[dj]].Dec <= det.Dec + deg_matchtol; dj++) {
+      if(distradec01(det.RA, det.Dec, alldets[detorder[dj]].RA, alldets[detorder[dj]].Dec) <= deg_matchtol) matchnum++;
     }
-    masterdetnum = masterpairdets.size();
-    cout << "The latest pairdets catalog had " << temppairdets.size() << " detections prior to\n";
-    cout << "de-duplication, and " << masterdetnum << " detections after\n";
-    // Sort the master pairdets vector
-    sort(masterpairdets.begin(), masterpairdets.end(), imgsort_hldet());
-    
-    // Perform index-matching from oldpairdets to masterpairdets.
-    olddetnum = oldpairdets.size();
-    make_lvec(olddetnum, old_detindex);
-    for(detct=0;detct<olddetnum;detct++) {
-      // Perform a binary search to identify a match to oldpairdets[detct] in masterpairdets.
-      i=0;
-      long istep = masterdetnum;
-      int search_direction=1;
-      while(search_direction!=0 && istep>=1) {
-	int foundit=0;
-	if(i<0) i=0;
-	else if(i>=masterdetnum) i = masterdetnum-1;
-	if(masterpairdets[i].image == oldpairdets[detct].image && fabs(masterpairdets[i].Dec - oldpairdets[detct].Dec) <= deg_matchtol) foundit=1;
-	else if(masterpairdets[i].image > oldpairdets[detct].image || (masterpairdets[i].image == oldpairdets[detct].image && masterpairdets[i].Dec > oldpairdets[detct].Dec)) {
-	  search_direction=-1;
-	  istep/=2;
-	  if(istep<1) istep=1;
-	  i -= istep;
-	  if(i<0) i=0;
-	} else if(masterpairdets[i].image < oldpairdets[detct].image || (masterpairdets[i].image == oldpairdets[detct].image && masterpairdets[i].Dec < oldpairdets[detct].Dec)) {
-	  search_direction=1;
-	  istep/=2;
-	  if(istep<1) istep=1;
-	  i += istep;
-	} else {
-	  cerr << "Logically forbidden case in binary search\n";
-	  cerr << "Images " << oldpairdets[detct].image << " and " << masterpairdets[i].image << "; Dec values " << oldpairdets[detct].Dec << " and " << masterpairdets[i].Dec << "\n";
-	}
-	if(foundit==1) {
-	  // Decrement i until we are certain to be below the match
-	  while(i>0 && (masterpairdets[i].image > oldpairdets[detct].image || (masterpairdets[i].image == oldpairdets[detct].image && masterpairdets[i].Dec >= oldpairdets[detct].Dec - deg_matchtol))) i--;
-	  // Now search upward until the match is found
-	  while(search_direction!=0 && i<masterdetnum && (masterpairdets[i].image < oldpairdets[detct].image || (masterpairdets[i].image == oldpairdets[detct].image && masterpairdets[i].Dec <= oldpairdets[detct].Dec + deg_matchtol))) {
-	    // Calculate the distance from detection i to detection detct
-	    double dist =  distradec01(oldpairdets[detct].RA, oldpairdets[detct].Dec, masterpairdets[i].RA, masterpairdets[i].Dec);
-	    if(dist<=deg_matchtol && masterpairdets[i].image == oldpairdets[detct].image) {
-	      old_detindex[detct]=i;
-	      search_direction=0;
-	    }
-	    i++;
-	  }
-	}
-      }
-      if(search_direction!=0) {
-	cerr << "ERROR: failed to match oldpairdets detection " << detct << " " << oldpairdets[detct].image << " " << oldpairdets[detct].MJD << " " << oldpairdets[detct].RA << " " << oldpairdets[detct].Dec << "\n";
-	return(3);
-      }
+    matchcount[dct] = matchnum;
+  }
+  partnervec = {};
+  for(detct=0;detct<detnum;detct++) {
+    one_lindex = long_index(matchcount[detct],detct);
+    partnervec.push_back(one_lindex);
+  }
+  // Sort partnervec by number of matches
+  sort(partnervec.begin(), partnervec.end(), lower_long_index());
+  // Loop over the detections in order of decreasing numbers of
+  // pair-partners. Each detection not already claimed as a duplicate
+  // is kept, and claims all of its unclaimed duplicates.
+  detrep = vector <long> (detnum,-1);
+  for(i=partnervec.size()-1 ; i>=0 ; i--) {
+    detct = partnervec[i].index;
+    if(detrep[detct]>=0) continue; // Already claimed as a duplicate
+    detrep[detct] = detct;
+    if(partnervec[i].lelem<=1) continue; // No duplicates
+    const hldet &det = alldets[detorder[detct]];
+    for(j=detct-1; j>=0 && alldets[detorder[j]].image == det.image && alldets[detorder[j]].Dec >= det.Dec - deg_matchtol; j--) {
+      if(detrep[j]<0 && distradec01(det.RA, det.Dec, alldets[detorder[j]].RA, alldets[detorder[j]].Dec) <= deg_matchtol) detrep[j] = detct;
     }
-    cout << "Finished index-matching from oldpairdets to masterpairdets.\n";
-    // Update detection indices in master_trk2det
-    for(i=0;i<long(master_trk2det.size());i++) {
-      detct = master_trk2det[i].i2;
-      master_trk2det[i].i2 = old_detindex[detct];
+    for(j=detct+1; j<detnum && alldets[detorder[j]].image == det.image && alldets[detorder[j]].Dec <= det.Dec + deg_matchtol; j++) {
+      if(detrep[j]<0 && distradec01(det.RA, det.Dec, alldets[detorder[j]].RA, alldets[detorder[j]].Dec) <= deg_matchtol) detrep[j] = detct;
     }
- 
-    // Perform index-matching from inpairdets to masterpairdets.
-    indetnum = inpairdets.size();
-    make_lvec(indetnum, in_detindex);
-    for(detct=0;detct<indetnum;detct++) {
-      // Perform a binary search to identify a match to inpairdets[detct] in masterpairdets.
-      i=0;
-      long istep = masterdetnum;
-      int search_direction=1;
-      while(search_direction!=0 && istep>=1) {
-	int foundit=0;
-	if(i<0) i=0;
-	else if(i>=masterdetnum) i = masterdetnum-1;
-	if(masterpairdets[i].image == inpairdets[detct].image && fabs(masterpairdets[i].Dec - inpairdets[detct].Dec) <= deg_matchtol) foundit=1;
-	else if(masterpairdets[i].image > inpairdets[detct].image || (masterpairdets[i].image == inpairdets[detct].image && masterpairdets[i].Dec > inpairdets[detct].Dec)) {
-	  search_direction=-1;
-	  istep/=2;
-	  if(istep<1) istep=1;
-	  i -= istep;
-	  if(i<0) i=0;
-	} else if(masterpairdets[i].image < inpairdets[detct].image || (masterpairdets[i].image == inpairdets[detct].image && masterpairdets[i].Dec < inpairdets[detct].Dec)) {
-	  search_direction=1;
-	  istep/=2;
-	  if(istep<1) istep=1;
-	  i += istep;
-	} else {
-	  cerr << "Logically forbidden case in binary search\n";
-	  cerr << "Images " << inpairdets[detct].image << " and " << masterpairdets[i].image << "; Dec values " << inpairdets[detct].Dec << " and " << masterpairdets[i].Dec << "\n";
-	}
-	if(foundit==1) {
-	  // Decrement i until we are certain to be below the match
-	  while(i>0 && (masterpairdets[i].image > inpairdets[detct].image || (masterpairdets[i].image == inpairdets[detct].image && masterpairdets[i].Dec >= inpairdets[detct].Dec - deg_matchtol))) i--;
-	  // Now search upward until the match is found
-	  while(search_direction!=0 && i<masterdetnum && (masterpairdets[i].image < inpairdets[detct].image || (masterpairdets[i].image == inpairdets[detct].image && masterpairdets[i].Dec <= inpairdets[detct].Dec + deg_matchtol))) {
-	    // Calculate the distance from detection i to detection detct
-	    double dist =  distradec01(inpairdets[detct].RA, inpairdets[detct].Dec, masterpairdets[i].RA, masterpairdets[i].Dec);
-	    if(dist<=deg_matchtol && masterpairdets[i].image == inpairdets[detct].image) {
-	      in_detindex[detct]=i;
-	      search_direction=0;
-	    }
-	    i++;
-	  }
-	}
-      }
-      if(search_direction!=0) {
-	cerr << "ERROR: failed to match inpairdets detection " << detct << " " << inpairdets[detct].image << " " << inpairdets[detct].MJD << " " << inpairdets[detct].RA << " " << inpairdets[detct].Dec << "\n";
-	return(3);
+  }
+  // Load the kept detections, which are already in sorted order,
+  // into masterpairdets, and map every input detection to its
+  // counterpart in masterpairdets.
+  masterpairdets = {};
+  newdetindex = vector <long> (detnum,-1);
+  for(detct=0;detct<detnum;detct++) {
+    if(detrep[detct]==detct) {
+      newdetindex[detct] = masterpairdets.size();
+      masterpairdets.push_back(alldets[detorder[detct]]);
+    }
+  }
+  detmap = vector <long> (detnum,-1);
+  for(detct=0;detct<detnum;detct++) detmap[detorder[detct]] = newdetindex[detrep[detct]];
+  masterdetnum = masterpairdets.size();
+  cout << "The concatenated pairdets catalog had " << detnum << " detections prior to\n";
+  cout << "de-duplication, and " << masterdetnum << " detections after\n";
+  alldets = {};
+  
+  // Recalculate the detection ranges for each image
+  detct=0;
+  for(masterimct=0;masterimct<masterimnum;masterimct++) {
+    masterimage[masterimct].startind = detct;
+    while(detct<masterdetnum && masterpairdets[detct].image==masterimct) detct++;
+    masterimage[masterimct].endind = detct;
+  }
+
+  // MERGE THE TRACKLETS
+  // Update the image indices in the tracklet files, the tracklet indices
+  // in the tracklet and trk2det files, and the detection indices in the
+  // trk2det files, and concatenate them.
+  mastertracklets={};
+  master_trk2det={};
+  for(filect=0;filect<filenum;filect++) {
+    master_trknum = mastertracklets.size();
+    for(trkct=0;trkct<long(intracklets_all[filect].size());trkct++) {
+      onetrk = intracklets_all[filect][trkct];
+      if(onetrk.Img1<0 || onetrk.Img1>=long(in_imindex[filect].size()) || onetrk.Img2<0 || onetrk.Img2>=long(in_imindex[filect].size())) {
+	cerr << "ERROR: tracklet " << trkct << " of file set " << filect << " has out-of-range image indices " << onetrk.Img1 << " " << onetrk.Img2 << "\n";
+	return(2);
       }
+      onetrk.Img1 = in_imindex[filect][onetrk.Img1];
+      onetrk.Img2 = in_imindex[filect][onetrk.Img2];
+      onetrk.trk_ID += master_trknum;
+      mastertracklets.push_back(onetrk);
     }
-    cout << "Finished index-matching from inpairdets to masterpairdets.\n";
-    // Update detection indices in intrk2det
-    for(i=0;i<long(intrk2det.size());i++) {
-      detct = intrk2det[i].i2;
-      intrk2det[i].i2 = in_detindex[detct];
+    for(i=0;i<long(intrk2det_all[filect].size());i++) {
+      onepair = intrk2det_all[filect][i];
+      if(onepair.i2<0 || detoffset[filect]+onepair.i2 >= (filect+1<filenum ? detoffset[filect+1] : detnum)) {
+	cerr << "ERROR: trk2det entry " << i << " of file set " << filect << " has out-of-range detection index " << onepair.i2 << "\n";
+	return(2);
+      }
+      onepair.i1 += master_trknum;
+      onepair.i2 = detmap[detoffset[filect]+onepair.i2];
+      master_trk2det.push_back(onepair);
     }
-    // Update tracklet indices in intracklets and intrk2det
-    for(trkct=0;trkct<in_trknum;trkct++) intracklets[trkct].trk_ID += master_trknum;
-    for(i=0;i<long(intrk2det.size());i++) intrk2det[i].i1 += master_trknum;
-    // Append intracklets to mastertracklets
-    for(trkct=0;trkct<in_trknum;trkct++) mastertracklets.push_back(intracklets[trkct]);
-    // Append intrk2det to master_trk2det
-    for(i=0;i<long(intrk2det.size());i++) master_trk2det.push_back(intrk2det[i]);
-
-    cout << "Finished adding tracklet set " << filect << "\n";
-    cout << "Total images now: " << masterimage.size() << "\n";
-    cout << "Total detections now: " << masterpairdets.size() << "\n";
-    cout << "Total tracklets now: " << mastertracklets.size() << "\n";
-    cout << "Length of trk2det vector now : " << master_trk2det.size() << "\n";
+    intracklets_all[filect] = {};
+    intrk2det_all[filect] = {};
   }
+  cout << "Total images: " << masterimage.size() << "\n";
+  cout << "Total detections: " << masterpairdets.size() << "\n";
+  cout << "Total tracklets prior to de-duplication: " << mastertracklets.size() << "\n";
+  cout << "Length of trk2det vector prior to de-duplication: " << master_trk2det.size() << "\n";
 
   // DE_DUPLICATE TRACKLETS
   // Hash all of the tracklets
@@ -567,53 +459,71 @@ int main(int argc, char *argv[])
   cout << "De-duplicated tracklets total: " << mastertracklets.size() << "\n";
   cout << "De-duplicated trk2det total: " << master_trk2det.size() << "\n";
   
-  // Write image file
+  // Write the four output files in parallel
   cout << "Writing output image catalog " << imagefile_out << " with " << masterimage.size() << " lines\n";
-  outstream1.open(imagefile_out);
-  for(masterimct=0;masterimct<long(masterimage.size());masterimct++) {
-    outstream1 << fixed << setprecision(8) << masterimage[masterimct].MJD << " " << masterimage[masterimct].RA;
-    outstream1 << fixed << setprecision(8) << " " << masterimage[masterimct].Dec << " " << masterimage[masterimct].obscode << " ";
-    outstream1 << fixed << setprecision(1) << masterimage[masterimct].X << " " << masterimage[masterimct].Y << " " << masterimage[masterimct].Z << " ";
-    outstream1 << fixed << setprecision(4) << masterimage[masterimct].VX << " " << masterimage[masterimct].VY << " " << masterimage[masterimct].VZ << " ";
-    outstream1 << masterimage[masterimct].startind << " " << masterimage[masterimct].endind << " " << masterimage[masterimct].exptime << "\n";
-  }
-  outstream1.close();
-
-  // Write paired detection file
   cout << "Writing paired detection file " << pairdetfile_out << " with " << masterpairdets.size() << " lines\n";
-  outstream1.open(pairdetfile_out);
-  outstream1 << "#MJD,RA,Dec,mag,trail_len,trail_PA,sigmag,sig_across,sig_along,image,idstring,band,obscode,known_obj,det_qual,origindex\n";
-  for(i=0;i<long(masterpairdets.size());i++) {
-    outstream1 << fixed << setprecision(7) << masterpairdets[i].MJD << "," << masterpairdets[i].RA << "," << masterpairdets[i].Dec << ",";
-    outstream1 << fixed << setprecision(4) << masterpairdets[i].mag << ",";
-    outstream1 << fixed << setprecision(2) << masterpairdets[i].trail_len << "," << masterpairdets[i].trail_PA << ",";
-    outstream1 << fixed << setprecision(4) << masterpairdets[i].sigmag << ",";
-    outstream1 << fixed << setprecision(3) << masterpairdets[i].sig_across << "," << masterpairdets[i].sig_along << ",";
-    outstream1 << masterpairdets[i].image << "," << masterpairdets[i].idstring << "," << masterpairdets[i].band << ",";
-    outstream1 << masterpairdets[i].obscode << "," << masterpairdets[i].known_obj << ","; 
-    outstream1 << masterpairdets[i].det_qual << "," << masterpairdets[i].index << "\n"; 
-  }
-  outstream1.close();
-
-  // Write tracklet file
   cout << "Writing tracklet file " << trackletfile_out << " with " << mastertracklets.size() << " lines\n";
-  outstream1.open(trackletfile_out);
-  outstream1 << "#Image1,RA1,Dec1,Image2,RA2,Dec2,npts,trk_ID\n";
-  for(i=0;i<long(mastertracklets.size());i++) {
-    outstream1 << fixed << setprecision(7) << mastertracklets[i].Img1 << "," << mastertracklets[i].RA1 << "," << mastertracklets[i].Dec1 << ",";
-    outstream1 << fixed << setprecision(7) << mastertracklets[i].Img2 << "," << mastertracklets[i].RA2 << "," << mastertracklets[i].Dec2 << ",";
-    outstream1 << mastertracklets[i].npts << "," << mastertracklets[i].trk_ID << "\n"; 
-  }
-  outstream1.close();
-
-  // Write trk2det file
   cout << "Writing trk2det file " << trk2detfile_out << " with " << master_trk2det.size() << " lines\n";
-  outstream1.open(trk2detfile_out);
-  outstream1 << "#trk_ID,detnum\n";
-  for(i=0;i<long(master_trk2det.size());i++) {
-    outstream1 << master_trk2det[i].i1 << "," << master_trk2det[i].i2 << "\n"; 
+  #pragma omp parallel sections private(i,masterimct)
+  {
+    #pragma omp section
+    {
+      // Write image file
+      ofstream outstream;
+      outstream.open(imagefile_out);
+      for(masterimct=0;masterimct<long(masterimage.size());masterimct++) {
+        outstream << fixed << setprecision(8) << masterimage[masterimct].MJD << " " << masterimage[masterimct].RA;
+        outstream << fixed << setprecision(8) << " " << masterimage[masterimct].Dec << " " << masterimage[masterimct].obscode << " ";
+        outstream << fixed << setprecision(1) << masterimage[masterimct].X << " " << masterimage[masterimct].Y << " " << masterimage[masterimct].Z << " ";
+        outstream << fixed << setprecision(4) << masterimage[masterimct].VX << " " << masterimage[masterimct].VY << " " << masterimage[masterimct].VZ << " ";
+        outstream << masterimage[masterimct].startind << " " << masterimage[masterimct].endind << " " << masterimage[masterimct].exptime << "\n";
+      }
+      outstream.close();
+    }
+    #pragma omp section
+    {
+      // Write paired detection file
+      ofstream outstream;
+      outstream.open(pairdetfile_out);
+      outstream << "#MJD,RA,Dec,mag,trail_len,trail_PA,sigmag,sig_across,sig_along,image,idstring,band,obscode,known_obj,det_qual,origindex\n";
+      for(i=0;i<long(masterpairdets.size());i++) {
+        outstream << fixed << setprecision(7) << masterpairdets[i].MJD << "," << masterpairdets[i].RA << "," << masterpairdets[i].Dec << ",";
+        outstream << fixed << setprecision(4) << masterpairdets[i].mag << ",";
+        outstream << fixed << setprecision(2) << masterpairdets[i].trail_len << "," << masterpairdets[i].trail_PA << ",";
+        outstream << fixed << setprecision(4) << masterpairdets[i].sigmag << ",";
+        outstream << fixed << setprecision(3) << masterpairdets[i].sig_across << "," << masterpairdets[i].sig_along << ",";
+        outstream << masterpairdets[i].image << "," << masterpairdets[i].idstring << "," << masterpairdets[i].band << ",";
+        outstream << masterpairdets[i].obscode << "," << masterpairdets[i].known_obj << ","; 
+        outstream << masterpairdets[i].det_qual << "," << masterpairdets[i].index << "\n"; 
+      }
+      outstream.close();
+    }
+    #pragma omp section
+    {
+      // Write tracklet file
+      ofstream outstream;
+      outstream.open(trackletfile_out);
+      outstream << "#Image1,RA1,Dec1,Image2,RA2,Dec2,npts,trk_ID\n";
+      for(i=0;i<long(mastertracklets.size());i++) {
+        outstream << fixed << setprecision(7) << mastertracklets[i].Img1 << "," << mastertracklets[i].RA1 << "," << mastertracklets[i].Dec1 << ",";
+        outstream << fixed << setprecision(7) << mastertracklets[i].Img2 << "," << mastertracklets[i].RA2 << "," << mastertracklets[i].Dec2 << ",";
+        outstream << mastertracklets[i].npts << "," << mastertracklets[i].trk_ID << "\n"; 
+      }
+      outstream.close();
+    }
+    #pragma omp section
+    {
+      // Write trk2det file
+      ofstream outstream;
+      outstream.open(trk2detfile_out);
+      outstream << "#trk_ID,detnum\n";
+      for(i=0;i<long(master_trk2det.size());i++) {
+        outstream << master_trk2det[i].i1 << "," << master_trk2det[i].i2 << "\n"; 
+      }
+      outstream.close();
+    }
   }
-  outstream1.close();
 
+  if(profilefile.size()>0) hlprof_write(profilefile, "merge_tracklet_files");
   return(0);
 }
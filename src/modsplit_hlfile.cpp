@@ -18,11 +18,12 @@
 
 static void show_usage()
 {
-  cerr << "Usage: modsplit_hlfile -sum summary_file -clust2det clust2detfile -splitnum number of parts -root root name for output cluster file\n";
+  cerr << "Usage: modsplit_hlfile -sum summary_file -clust2det clust2detfile -splitnum number of parts -root root name for output cluster file -profile profile_file\n";
 }
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   string clusterlist,clusterlist2;
   string sumfile,clust2detfile;
   string sumfile_part,clust2detfile_part;
@@ -107,12 +108,28 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   // Catch required parameters if missing
   if(sumfile.size()<=0) {
     cout << "\nERROR: input summary file is required\n";
@@ -213,5 +230,6 @@ int main(int argc, char *argv[])
   }
   outstream3.close();
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "modsplit_hlfile");
   return(0);
 }
@@ -12,11 +12,12 @@
 
 static void show_usage()
 {
-  cerr << "Usage: parse_clust2det -pairdet pairdet_file -insum input cluster summary file -clust2det input cluster-to-detection file -trackdiv tracklet_division_time -out output file\n";
+  cerr << "Usage: parse_clust2det -pairdet pairdet_file -insum input cluster summary file -clust2det input cluster-to-detection file -trackdiv tracklet_division_time -out output file -profile profile_file\n";
 }
 
 int main(int argc, char *argv[])
 {
+  string profilefile;
   string sumfile,clust2detfile,outfile;
   vector <hlclust> inclustvec;
   vector  <longpair> inclust2det;
@@ -133,12 +134,28 @@ int main(int argc, char *argv[])
 	show_usage();
 	return(1);
       }
+    } else if(string(argv[i]) == "-profile" || string(argv[i]) == "-prof" || string(argv[i]) == "--profile") {
+      if(i+1 < argc) {
+	//There is still something to read;
+	profilefile=argv[++i];
+	i++;
+      }
+      else {
+	cerr << "Profile output file keyword supplied with no corresponding argument\n";
+	show_usage();
+	return(1);
+      }
     } else {
       cerr << "Warning: unrecognized keyword or argument " << argv[i] << "\n";
       i++;
     }
   }
 
+  if(profilefile.size()>0) {
+    hlprof_enable(1);
+    cout << "Timing and memory profile will be written to " << profilefile << "\n";
+  }
+
   // Catch required parameters if missing
   if(pairdetfile.size()<=0) {
     cout << "\nERROR: input paired detection file is required\n";
@@ -406,5 +423,6 @@ int main(int argc, char *argv[])
   }
   outstream1.close();
   
+  if(profilefile.size()>0) hlprof_write(profilefile, "parse_clust2det");
   return(0);
 }
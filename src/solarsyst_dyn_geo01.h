@@ -23,7 +23,10 @@
 #include <cstdio>
 #include <cassert>
 #include <climits>
+#include <cfloat>
 #include <chrono>
+#include <atomic>
+#include <mutex>
 
 #include <omp.h>
 
@@ -119,6 +122,10 @@ using namespace std;
 #define PHASECONST_B1 0.63L
 #define PHASECONST_B2 1.22L
 #define PHASE_G 0.15
+#define FASTTRIG_ROUND 6755399441055744.0 // 1.5*2^52: (x + FASTTRIG_ROUND) - FASTTRIG_ROUND rounds x
+                                          // to the nearest integer, without a call to libm.
+#define FASTTRIG_MAXERR_MAS 1.0 // Error bound, in milliarcseconds, guaranteed for the batch trig
+                                // kernels (sincos_batch, distradec02_batch, etc.) relative to libm.
 #define WARN_INVERSE_TRIG 0 // If 0, don't print warning messages about taking arcsin or arccos of values
                             // or arccos of values infinitesimally outside the range [-1,1]. Just collapse
                             // them to exactly 1.0 or -1.0 like a good robot.
@@ -187,9 +194,42 @@ using namespace std;
                               // in seconds, are implausible and will cause link_refine_Herget
                               // to exit with an error.
 // End parameters related to heliolinc clustering
+#define HYPMATCHTOL 2.0e-6 // Tolerance for matching the heliocentric hypothesis recorded in a
+                           // cluster summary file (heliohyp0, heliohyp1, heliohyp2, written
+                           // with six decimal places) to a point in the hypothesis grid.
+#define HYPSAME_TOL 1.0e-12 // Tolerance for deciding two points in a hypothesis grid share
+                            // the same distance, velocity, or acceleration.
+#define COARSE_CELLBITS 21 // Bits per axis in the packed key of a coarse pre-screening cell,
+                           // so cell indices must lie within +/- 2^20 on each axis.
+#define MAXNIGHTMASK 64 // Maximum number of NIGHTSTEP-wide time bins that can be tracked
+                        // in the unsigned long night bitmask used for coarse pre-screening.
+#define COMPACT_QUANTA 64 // Target number of quantization steps per clustering radius for
+                          // the compact (16-bit) state vectors used in heliolinc_alg_lowmem.
+#define COMPACT_MINQUANTA 8 // If a geocentric bin spans too wide a range to keep at least this many
+                            // quantization steps per clustering radius in 16 bits, it falls back
+                            // on the full-precision clustering path.
 #define MAXTANVELCUT 50.0 // Maximum value that can be placed on the minimum tangential velocity in km/sec
                           // for a valid tracklet in heliolinc. Note that setting it anywhere near
                           // this would reject almost all tracklets.
+#define MERGE_PARALLEL_MIN 20000 // Minimum number of elements for which merge_cluster_buffers
+                                // copies the per-thread buffers in parallel rather than serially.
+#define SORT_PARALLEL_MIN 100000 // Minimum number of keys for which radix_sort_index runs its
+                                // histogram and scatter passes in parallel.
+#define HLLOG_ERROR 0 // Message levels for HLLOG. ERROR and WARN go to stderr, the rest to stdout.
+#define HLLOG_WARN 1
+#define HLLOG_INFO 2 // Summary information, printed once per call or per hypothesis
+#define HLLOG_PROGRESS 3 // Progress through a long loop: per image, per geocentric bin, etc.
+#define HLLOG_DEBUG 4 // Verbose diagnostics, normally also gated by a function's verbose argument
+#define HLLOG_TRACE 5 // Per-cluster or per-tracklet detail for debugging the library itself
+#ifndef HLLOG_MAXLEVEL
+#define HLLOG_MAXLEVEL HLLOG_DEBUG // Compile-time ceiling: HLLOG calls above this level compile
+                                   // to nothing. Override with, e.g., -DHLLOG_MAXLEVEL=HLLOG_INFO
+#endif
+// HLLOG(level, a << b << ...): format a message as with cout, and write it
+// through hllog_write if level is within both the compile-time ceiling and
+// the run-time threshold set by hllog_set_level. With a constant level above
+// HLLOG_MAXLEVEL, the whole statement is eliminated by the compiler.
+#define HLLOG(level, ...) do { if((level)<=HLLOG_MAXLEVEL && (level)<=hllog_level()) { ostringstream hllog_stream; hllog_stream << __VA_ARGS__; hllog_write((level), hllog_stream.str()); } } while(0)
 
 // Begin set or parameters related to the Everhart (1974) integrator
 #define h3_1 0.0l
@@ -459,6 +499,24 @@ struct HeliolincConfig {
                                // we set it to positive values. In this case it is also necessary
                                // to set use_univar=1, since only the universal variable formulation
                                // can handle unbound orbits.
+  int prescreen = 0;           // Coarse pre-screen before full k-d tree clustering: 0 = off
+                               // (exhaustive search); 1 = in each geocentric bin, cluster only
+                               // state vectors near a coarse position cell with enough tracklets
+                               // and observing nights to form a valid linkage; 2 = run both the
+                               // pre-screened and the exhaustive search, and report the recall
+                               // difference. Applies only to the default form_clusters_kd4 path.
+  int compact = 0;             // Low-memory version only: if 1, quantize the state vectors in each
+                               // geocentric bin into compact 16-bit form (class point6sx1) for
+                               // clustering. Cuts the clustering working set by more than a factor
+                               // of two, at the cost of a quantization error of order 1/COMPACT_QUANTA
+                               // of the clustering radius.
+  int float32 = 0;             // Propagate state vectors to MJDref in single precision (trk2statevec_fgfunc32):
+                               // 0 = off (double precision); 1 = float32; 2 = float32, but also
+                               // run the double-precision version and report the worst-case
+                               // state vector discrepancy relative to clustrad. Applies only to
+                               // the default f and g function path (use_univar = 0, 4, or 6).
+  int echo_config = 1;         // Low-memory version only: if 0, skip the echo of these configuration
+                               // parameters, for callers that run many batches with the same config.
   int verbose=0;
 };
 
@@ -572,6 +630,7 @@ struct FindGlintsConfig {       // Note that the pixel-xy and RA/Dec versions us
                                // frequency even if only 1/3 of the flashes were detected.
   double max_phase_err = 0.02; // Determines the sampling interval for the frequency search, which is
                                // set to max_phase_err/traillen
+  int verbose = 0;             // If >0, report progress for each image searched.
 };
 
 
@@ -613,6 +672,13 @@ public:
   hlradhyp() = default;
 };
 
+class lower_hlradhyp{ // Sort hlradhyp by distance, then velocity, then acceleration
+public:
+  inline bool operator() (const hlradhyp& h1, const hlradhyp& h2) {
+    return(h1.HelioRad < h2.HelioRad || (h1.HelioRad == h2.HelioRad && h1.R_dot < h2.R_dot) || (h1.HelioRad == h2.HelioRad && h1.R_dot == h2.R_dot && h1.R_dubdot < h2.R_dubdot));
+  }
+};
+
 class hlclust{ // cluster (linkage) type used as output by heliolinc and I/O by link_refine
 public:
   long clusternum;
@@ -845,6 +911,13 @@ public:
   longpair() = default;
 };
 
+class lower_longpair{ // Sort longpair by i1, then by i2
+public:
+  inline bool operator() (const longpair& p1, const longpair& p2) {
+    return(p1.i1 < p2.i1 || (p1.i1 == p2.i1 && p1.i2 < p2.i2));
+  }
+};
+
 class uint_pair{ // Pair of unsigned integers
 public:
   unsigned int i1;
@@ -870,6 +943,15 @@ public:
   point3d() = default;
 };
 
+class point3f{ // Single-precision 3-D point
+public:
+  float x;
+  float y;
+  float z;
+  point3f(float x, float y, float z) :x(x), y(y), z(z) { }
+  point3f() = default;
+};
+
 class point3d_index{ // Double-precision 3-D point with long-integer idex
 public:
   double x;
@@ -1165,6 +1247,28 @@ public:
 };
 
 
+class point6sx1{  // Compact version of point6ix2, used by the low-memory version
+                  // of heliolinc. The 6-D point is quantized into 16-bit integers
+                  // relative to an origin near the center of a geocentric bin, in
+                  // units of a quantum tied to the clustering radius. The single
+                  // index is the tracklet index, equivalent to point6ix2.i1.
+                  // Occupies 16 bytes, as opposed to 40 for point6ix2.
+public:
+  short c[6]; // x, y, z, vx, vy, vz, in that order.
+  unsigned int i1;
+  point6sx1(short x, short y, short z, short vx, short vy, short vz, unsigned int i1) :c{x, y, z, vx, vy, vz}, i1(i1) {}
+  point6sx1() = default;
+};
+
+class lower_point6sx1{ // Sort point6sx1's along a specified dimension (0-5)
+public:
+  int dim;
+  lower_point6sx1(int dim) :dim(dim) {}
+  inline bool operator() (const point6sx1& p1, const point6sx1& p2) {
+    return(p1.c[dim] < p2.c[dim]);
+  }
+};
+
 class point3ix2{  // integer 3-D point plus 2 long integer indices
                   // The integer 3-D point is supposed to hold integerized
                   // versions of dynamical position state vectors (X, Y, Z).
@@ -1680,6 +1784,65 @@ public:
   glint_trail() = default;
 };
 
+class hlprof_entry{ // Accumulated statistics for one instrumented stage or counter
+                    // in the optional profiling layer (see hlprof_enable). The
+                    // fields are atomic, so an entry can be updated from inside
+                    // OpenMP parallel regions without locking.
+public:
+  string name;
+  atomic<long> calls;      // Number of completed timed calls
+  atomic<long> nanosec;    // Total wall-clock time of all calls, in nanoseconds
+  atomic<long> maxnanosec; // Longest single call, in nanoseconds
+  atomic<long> count;      // Counter value, from hlprof_count
+  atomic<long> peak_rss;   // Process memory high-water mark (kB) at the end of the latest call,
+                           // recorded only if sample_rss is set (see hlprof_lookup)
+  int sample_rss;          // 1 for the outer pipeline stages, whose timers also sample memory
+  hlprof_entry(const string &name, int sample_rss) :name(name), calls(0), nanosec(0), maxnanosec(0), count(0), peak_rss(0), sample_rss(sample_rss) { }
+};
+
+class hlprof_timer{ // Scoped timer: adds the wall-clock time from construction to
+                    // destruction to an hlprof_entry. Does nothing unless profiling
+                    // is enabled, or if the entry is NULL.
+public:
+  hlprof_timer(hlprof_entry *entry);
+  ~hlprof_timer();
+private:
+  hlprof_entry *entry;
+  chrono::steady_clock::time_point start;
+};
+
+class hlhypstat{ // Performance and yield statistics for one heliocentric hypothesis
+                 // in a heliolinc run, as written by write_hypstat_file.
+public:
+  long hypindex;        // Index of the hypothesis in the input hypothesis file
+  double HelioRad;      // Heliocentric distance in AU
+  double R_dot;         // Heliocentric radial velocity in AU/day
+  double R_dubdot;      // Heliocentric radial acceleration in units of -GMsun/r^2
+  double statevec_time; // Wall-clock time spent in trk2statevec, in seconds
+  double cluster_time;  // Wall-clock time spent in form_clusters, in seconds
+  long statevecs;       // Number of physically reasonable state vectors
+  long treesize;        // Points in k-d trees, summed over geocentric bins
+  long rangequeries;    // k-d range queries, summed over geocentric bins
+  long rawclusters;     // Clusters found by the range queries, before any cuts
+  long linkages;        // Linkages passing all cuts and in-hypothesis de-duplication
+  long dedup_linkages;  // Linkages surviving the final de-duplication over all hypotheses
+  vector <long> geobin_statevecs; // Number of state vectors in each geocentric bin
+  hlhypstat(long hypindex, double HelioRad, double R_dot, double R_dubdot, double statevec_time, double cluster_time, long statevecs, long treesize, long rangequeries, long rawclusters, long linkages, long dedup_linkages, const vector <long> &geobin_statevecs) :hypindex(hypindex), HelioRad(HelioRad), R_dot(R_dot), R_dubdot(R_dubdot), statevec_time(statevec_time), cluster_time(cluster_time), statevecs(statevecs), treesize(treesize), rangequeries(rangequeries), rawclusters(rawclusters), linkages(linkages), dedup_linkages(dedup_linkages), geobin_statevecs(geobin_statevecs) { }
+  hlhypstat() = default;
+};
+
+class pair_adjacency{ // Pair partners of each paired detection, in compressed sparse
+                      // row (CSR) form: the partners of detection i are
+                      // partner[offset[i]] through partner[offset[i]+degree[i]-1].
+                      // Built by make_pair_adjacency; degree[i] is set to zero when
+                      // merge_pairs claims detection i for an exclusive tracklet.
+public:
+  vector <long> offset;  // detnum+1 offsets into partner
+  vector <long> partner; // Partner indices, two entries per pair
+  vector <long> degree;  // Number of live partners of each detection
+  long size() const { return(degree.size()); }
+};
+
 void make_ivec(long nx, vector <int> &ivec);
 void make_imat(int nx, int ny, vector <vector <int>> &imat);
 void make_lvec(int nx, vector <long> &lvec);
@@ -1712,6 +1875,13 @@ int celedeproj01LD(point3LD p3, long double *RA, long double *Dec);
 double angspeed01(det_bsc o1, det_bsc o2);
 double distradec01(double RA1, double Dec1, double RA2, double Dec2);
 int distradec02(double ra1,double dec1,double ra2,double dec2,double *dist,double *pa);
+int sincos_batch(long n, const double *x, double *sinx, double *cosx);
+int atan2_batch(long n, const double *y, const double *x, double *angle);
+int celeproj01_batch(long n, const double *RA, const double *Dec, point3d *unitvec);
+int celestial_to_stateunit_batch(long n, const double *RA, const double *Dec, point3d *unitvec);
+int distradec02_batch(double ra1, double dec1, long n, const double *ra2, const double *dec2, double *dist, double *pa);
+int distradec02_xy_batch(double ra0, double dec0, long n, const double *ra, const double *dec, double *x, double *y);
+int unitvec_xy_proj(double ra0, double dec0, long n, const point3d *unitvec, double *x, double *y);
 long medindex(const vector <xy_index> &xyvec, int dim);
 int splitxy(const vector <xy_index> &xyvec, int dim, long unsigned int splitpoint, vector <xy_index> &left, vector <xy_index> &right);
 int kdtree01(const vector <xy_index> &xyvec, int dim, long unsigned int rootptxy, long unsigned int rootptkd, vector <kdpoint> &kdvec);
@@ -1729,6 +1899,7 @@ double point4d_index_dist2(const point4d_index &p1, const point4d_index &p2);
 int kdrange_4d_index(const vector <KD_point4d_index> &kdvec, const point4d_index &querypoint, double range, vector <long> &indexvec);
 long kdnearest_4d_index_verbose(const vector <KD_point4d_index> &kdvec, const point4d_index &querypoint);
 long kdnearest_4d_index(const vector <KD_point4d_index> &kdvec, const point4d_index &querypoint);
+int crossmatch_4d_index(const vector <KD_point4d_index> &kdvec, const vector <point4d_index> &queryvec, double range, int usenearest, double timebin, double skycell, long batchsize, vector <long_index> &matches, int verbose);
 long medind_6LDx2(const vector <point6LDx2> &pointvec, int dim);
 int splitLDx2(const vector <point6LDx2> &pointvec, int dim, long unsigned int splitpoint, vector <point6LDx2> &left, vector <point6LDx2> &right);
 int kdtree_6D01(const vector <point6LDx2> &invec, int dim, long unsigned int splitpoint, long unsigned int kdroot, vector <KD_point6LDx2> &kdvec);
@@ -1750,7 +1921,15 @@ int kdrange_6i01(const vector <KD_point6ix2> &kdvec, const point6ix2 &querypoint
 double cluster_stats6i01(const vector <KD_point6ix2> &cluster, double intconvscale, vector <double> &meanvals, vector <double> &rmsvals);
 double cluster_stats6i02(const vector <point6ix2> &cluster, double intconvscale, vector <double> &meanvals, vector <double> &rmsvals);
 int DBSCAN_6i01(vector <KD_point6ix2> &kdtree, double clustrad, int npt, double intconvscale, vector <KD6i_clust> &outclusters, int verbose);
+long uf_find_atomic(vector <atomic <long>> &parent, long i);
+void uf_union_atomic(vector <atomic <long>> &parent, long a, long b);
+int DBSCAN_6i02(vector <KD_point6ix2> &kdtree, double clustrad, int npt, double intconvscale, vector <KD6i_clust> &outclusters, int verbose);
 int KDRclust_6i01(vector <KD_point6ix2> &kdtree, double clustrad, int npt, double intconvscale, vector <KD6i_clust> &outclusters, int verbose);
+point6ix2 decompact_6sx1(const point6sx1 &p1, const point6ix2 &origin, long quantum);
+int kdtree_6sx1(vector <point6sx1> &pointvec, long lo, long hi, int dim);
+int kdrange_6sx1(const vector <point6sx1> &pointvec, const point6sx1 &querypoint, double range, vector <long> &indexvec);
+int KDRclust_6sx1(const vector <point6sx1> &pointvec, const point6ix2 &origin, long quantum, double clustrad, int npt, double intconvscale, vector <KD6i_clust> &outclusters, int verbose);
+int KDRclust_6i01_incr(vector <KD_point6ix2> &kdtree, double clustrad, int npt, double intconvscale, long firstnew, vector <KD6i_clust> &outclusters, long &querynum, int verbose);
 long medind_3ix2(const vector <point3ix2> &pointvec, int dim);
 int split3ix2(const vector <point3ix2> &pointvec, int dim, long unsigned int splitpoint, vector <point3ix2> &left, vector <point3ix2> &right);
 int kdtree_3i01(const vector <point3ix2> &invec, int dim, long unsigned int splitpoint, long unsigned int kdroot, vector <KD_point3ix2> &kdvec);
@@ -1761,6 +1940,8 @@ int celestial_to_statevec(double RA, double Dec,double delta,point3d &baryvec);
 int celestial_to_statevec2(double RA, double Dec,double delta, vector <double> &baryvec);
 int celestial_to_statevecLD(long double RA, long double Dec,long double delta,point3LD &baryvec);
 int celestial_to_stateunit(double RA, double Dec,point3d &baryvec);
+int tracklet_unit_vectors(const vector <tracklet> &tracklets, vector <point3d> &trkunit);
+int detection_unit_vectors(const vector <hldet> &detvec, vector <point3d> &detunit);
 int celestial_to_SVunit(double RA, double Dec, vector <double> &baryvec);
 int celestial_to_stateunitLD(long double RA, long double Dec, point3LD &baryvec);
 int celestial_to_cartunit(double RA, double Dec,point3d &cartvec);
@@ -1808,6 +1989,7 @@ int helioproj01(point3d unitbary, point3d obsbary,double heliodist,double &geodi
 int helioproj01LD(point3LD unitbary, point3LD obsbary, long double heliodist, long double &geodist, point3LD &projbary);
 int helioproj02LD(point3LD unitbary, point3LD obsbary, long double heliodist, vector <long double> &geodist, vector <point3LD> &projbary);
 int helioproj02(point3d unitbary, point3d obsbary, double heliodist, vector <double> &geodist, vector <point3d> &projbary);
+int helioproj02_noalloc(const point3d &unitbary, const point3d &obsbary, double heliodist, double geodist[2], point3d projbary[2]);
 int accelcalc01LD(int planetnum, const vector <long double> &planetmasses, const vector <point3LD> &planetpos, const point3LD &targpos, point3LD &accel);
 int integrate_orbit_constac(int planetnum, const vector <long double> &planetmjd, const vector <long double> &planetmasses, const vector <point3LD> &planetpos, long double mjdstart, point3LD startpos, point3LD startvel, long double mjdend, point3LD &endpos, point3LD &endvel);
 long double kep_transcendental(long double q, long double e, long double tol);
@@ -1817,6 +1999,7 @@ int Stumpff_func_cf(const double xc, double *c0, double *c1, double *c2, double
 int Keplerint(const long double MGsun, const long double mjdstart, const point3LD &startpos, const point3LD &startvel, const long double mjdend, point3LD &endpos, point3LD &endvel);
 int Keplerint(const double MGsun, const double mjdstart, const point3d &startpos, const point3d &startvel, const double mjdend, point3d &endpos, point3d &endvel);
 int Kepler_fg_func_int(const double MGsun, const double mjdstart, const point3d &startpos, const point3d &startvel, const double mjdend, point3d &endpos, point3d &endvel);
+int Kepler_fg_func_intf(const float MGsun, const float deltat, const point3f &startpos, const point3f &startvel, point3f &endpos, point3f &endvel);
 int Kepler_fg_func_int_Ryder_Halley(const double MGsun, const double mjdstart, const point3d &startpos, const point3d &startvel, const double mjdend, point3d &endpos, point3d &endvel);
 int Kepler_fg_func_vec(const double MGsun, const double mjdstart, const point3d &startpos, const point3d &startvel, const vector <double> &mjdvec, vector <point3d> &outpos, vector <point3d> &outvel);
 int Kepler_univ_int(const double MGsun, const double mjdstart, const point3d &startpos, const point3d &startvel, const double mjdend, point3d &endpos, point3d &endvel, int verbose);
@@ -1849,6 +2032,11 @@ int polyfit02(const vector <double> &yvec, const vector <double> &sigvec, const
 int multilinfit02b(const vector <double> &yvec, const vector <double> &varvec, const vector <vector <double>> &xmat, int pnum, int fitnum, vector <double> &avec, int verbose);
 int arc2cel01(double racenter,double deccenter,double dist,double pa,double &outra,double &outdec);
 int obscode_lookup(const vector <observatory> &observatory_list, const char* obscode, double &obslon, double &plxcos,double &plxsin);
+int obscode_key(const char *obscode);
+int make_obscode_index(const vector <observatory> &observatory_list, unordered_map <int, long> &obsindex);
+int radix_sort_index(vector <unsigned long> &keys, vector <long> &ind);
+int sort_hldet_parallel(vector <hldet> &detvec, double imagetimetol);
+int obscode_lookup(const unordered_map <int, long> &obsindex, const vector <observatory> &observatory_list, const char* obscode, double &obslon, double &plxcos,double &plxsin);
 string intzero01i(const int i, const int n);
 int get_col_vector01(const string &lnfromfile, vector <string> &outvec);
 int mjd2mpcdate(double MJD,int &year,int &month,double &day);
@@ -1877,6 +2065,8 @@ long double unitvar(mt19937_64 &generator);
 double gaussian_deviate_mt(mt19937_64 &generator);
 int vaneproj01LD(point3LD unitbary, point3LD obsbary, long double ecliplon, long double &geodist, point3LD &projbary);
 int vaneproj01d(point3d unitbary, point3d obsbary, double ecliplon, double min_proj_sine, double &geodist, point3d &projbary);
+int tracklet_sun_elongations(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, vector <double> &trkelong);
+int vaneproj_batch(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, const vector <double> &trkelong, const vector <double> &lambdavec, double minsunelong, double maxsunelong, double min_proj_sine, double maxheliodist, vector <double> &geodist, vector <point3d> &projbary, vector <int> &projstatus);
 double Twopoint_KepQ(double x);
 //int Twopoint_Qf(double z, double MGsun, double lambda1, double lambda2, double X, double Y, double deltat, double *f, double *fprime);
 int Twopoint_Kepler_vel(const double MGsun, const point3d startpoint, const point3d endpoint, const double timediff, point3d &startvel, double *semimaj, int itmax);
@@ -1941,6 +2131,9 @@ int read_tracklet_file(string trackletfile, vector <tracklet> &tracklets, int ve
 int read_longpair_file(string pairfile, vector <longpair> &pairvec, int verbose);
 int append_longpair_file(string pairfile, long oldsize, vector <longpair> &pairvec, int verbose);
 int read_radhyp_file(string hypfile, vector <hlradhyp> &accelmat, int verbose);
+int read_hypcost_file(string costfile, int costcol, vector <double> &hypcost, int verbose);
+int read_streamstate_file(string statefile, double &MJDref, double &chartimescale, long &hypnum, vector <vector <point6ix2>> &hypstate, int verbose);
+int write_streamstate_file(string statefile, double MJDref, double chartimescale, const vector <vector <point6ix2>> &hypstate);
 int read_clustersum_file(string sumfile, vector <hlclust> &clustvec, int verbose);
 int append_clustersum_file(string sumfile, vector <hlclust> &clustvec, int verbose);
 double avg_extrema(const vector <double> &x);
@@ -1951,6 +2144,9 @@ int load_image_table(vector <img_log03> &img_log, const vector <det_obsmag_indve
 int load_image_table(vector <hlimage> &img_log, const vector <hldet> &detvec, double time_offset, const vector <observatory> &observatory_list, const vector <double> &EarthMJD, const vector <point3d> &Earthpos, const vector <point3d> &Earthvel);
 int load_image_indices(vector <hlimage> &img_log, vector <hldet> &detvec, double imagetimetol, int forcerun);
 int load_image_indices2(vector <hlimage> &img_log, vector <hldet> &detvec, double imagetimetol, int forcerun);
+int make_pair_adjacency(long detnum, const vector <longpair> &pairvec, pair_adjacency &adj);
+int make_pair_adjacency(const vector <vector <long>> &indvecs, pair_adjacency &adj);
+int find_pairs(vector <hldet> &detvec, const vector <hlimage> &img_log, vector <hldet> &pairdets, pair_adjacency &adj, vector <longpair> &pairvec, double mintime, double maxtime, double imrad, double maxvel, int verbose);
 int find_pairs(vector <hldet> &detvec, const vector <hlimage> &img_log, vector <hldet> &pairdets, vector <vector <long>> &indvecs, vector <longpair> &pairvec, double mintime, double maxtime, double imrad, double maxvel, int verbose);
 int find_pairs2(vector <hldet> &detvec, const vector <hlimage> &img_log, vector <hldet> &pairdets, vector <tracklet> &tracklets, vector <longpair> &trk2det, int min_tracklet_points, int max_netl, double mintime, double maxtime, double imagetimetol, double imrad, double minvel, double maxvel, double minarc, double matchrad, double trkfrac, double maxgcr, int verbose);
 int delete_tracklet01(long overtrk, vector <long> &trkdetind, vector <long> &trkindind, vector <hldet> &detvec, vector <longpair> &trk2det, vector <tracklet> &tracklets, vector <hldet> &pairdets, vector <double> &tracklet_metrics, vector <long> &det2trk, vector <long> &tracklets_min_length, vector <vector <long>> &tracklet_indexmat, vector <long> &overlapping_tracklets, int verbose);
@@ -1960,13 +2156,22 @@ int delete_trkpts01(vector <hldet> &detvec, vector <hldet> &pairdets, vector <lo
 int find_repdets(const vector <hldet> &imdetvec, double RA, double Dec, vector <hldet> &repdetvec, int verbose);
 int calculate_overlap(const vector <hldet> &detvec, const vector <hlimage> &img_log, double mintime, double maxtime, double maxvel, double imrad, double matchrad, vector <int> &image_overlap, int verbose);
 int find_pairs5(vector <hldet> &detvec, const vector <hlimage> &img_log, vector <hldet> &pairdets, vector <tracklet> &tracklets, vector <longpair> &trk2det, int min_tracklet_points, int max_netl, double mintime, double maxtime, double imagetimetol, double imrad, double minvel, double maxvel, double minarc, double matchrad, double trkfrac, double maxgcr, int verbose);
+int trailpair_consistency(const vector <hldet> &detvec, long indexA, const vector <long> &indexBvec, double timediff, double exptimeA, double exptimeB, double siglenscale, double sigpascale, vector <int> &isgood);
 int find_trailpairs(vector <hldet> &detvec, const vector <hlimage> &img_log, vector <hldet> &pairdets, vector <vector <long>> &indvecs, vector <longpair> &pairvec, double mintime, double maxtime, double imrad, double maxvel, double siglenscale, double sigpascale, int verbose);
+int merge_pairs(const vector <hldet> &pairdets, pair_adjacency &adj, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
 int merge_pairs(const vector <hldet> &pairdets, vector <vector <long>> &indvecs, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
+int merge_pairs2(const vector <hldet> &pairdets, pair_adjacency &adj, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, int max_netl, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
 int merge_pairs2(const vector <hldet> &pairdets, vector <vector <long>> &indvecs, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, int max_netl, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
+int linfit_xy_resid(long npts, const double *t, const double *x, const double *y, double &slopex, double &interceptx, double &slopey, double &intercepty, double *fiterr, double &GCR);
+int pair_components(const pair_adjacency &adj, vector <long> &compid);
+int merge_pairs3(const vector <hldet> &pairdets, const vector <point3d> &detunit, pair_adjacency &adj, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, const vector <int> image_overlap, double trkfrac, int max_netl, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
+int merge_pairs3(const vector <hldet> &pairdets, pair_adjacency &adj, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, const vector <int> image_overlap, double trkfrac, int max_netl, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
 int merge_pairs3(const vector <hldet> &pairdets, vector <vector <long>> &indvecs, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, const vector <int> image_overlap, double trkfrac, int max_netl, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
 int merge_trailpairs(const vector <hldet> &pairdets, vector <vector <long>> &indvecs, const vector <longpair> &pairvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, int mintrkpts, double maxgcr, double minarc, double minvel, double maxvel, int verbose);
 int find_glints_radec(const vector <point3d_index> &detvec, FindGlintsConfig config, vector <glint_trail> &trailvec, vector <longpair> &trail2det);
 int find_glints_xypix(const vector <point3d_index> &detvec, FindGlintsConfig config, vector <glint_trail> &trailvec, vector <longpair> &trail2det);
+int find_glints_catalog(const vector <point3d_index> &detvec, const vector <hlimage> &image_log, FindGlintsConfig config, int use_xypix, vector <glint_trail> &trailvec, vector <longpair> &trail2det, int verbose);
+int exclude_glint_dets(vector <hldet> &detvec, vector <hlimage> &image_log, FindGlintsConfig config, vector <glint_trail> &trailvec, vector <longpair> &trail2det, int verbose);
 int record_pairs(vector <hldet> &detvec, vector <hldet> &detvec_fixed, vector <tracklet> &tracklets, vector <longpair> &trk2det, int verbose);
 int make_tracklets(vector <hldet> &detvec, vector <hlimage> &image_log, MakeTrackletsConfig config, vector <hldet> &pairdets,vector <tracklet> &tracklets, vector <longpair> &trk2det);
 int make_tracklets2(vector <hldet> &detvec, vector <hlimage> &image_log, MakeTrackletsConfig config, vector <hldet> &pairdets,vector <tracklet> &tracklets, vector <longpair> &trk2det);
@@ -1982,13 +2187,21 @@ int make_trailed_tracklets2(vector <hldet> &detvec, vector <hlimage> &image_log,
 int remake_tracklets(vector <hldet> &detvec, vector <hldet> &detvec_fixed, vector <hlimage> &image_log,vector <tracklet> &tracklets, vector <longpair> &trk2det, int verbose);
 int trk2statevec(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar);
 int trk2statevec_fgfunc(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler);
+int trk2statevec_fgfunc(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler);
+int trk2statevec_fgfunc32(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler);
+int statevec_discrepancy(const vector <point6ix2> &statevecs1, const vector <point6ix2> &statevecs2, double &maxdist, long &unmatched);
 int trk2statevec_fgfuncRR(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler);
+int trk2statevec_fgfuncRR(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler);
 int trk2statevec_clusterprobe(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6dx2> &allstatevecs, double mjdref);
 int trk2statevec_clusterprobe_innea(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6dx2> &allstatevecs, double mjdref);
 int trk2statevec_univar(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler, int verbose);
+int trk2statevec_univar(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler, int verbose);
 int trk2statevec_univarRR(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler, int verbose);
+int trk2statevec_univarRR(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int NotKepler, int verbose);
 int trk2statevane_fgfunc(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double lambda0, double lambda_dot, double lambda_ddot, double chartimescale, double minsunelong, double maxsunelong, double min_proj_sine, double max_heliodist, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf);
 int trk2statevane_univar(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double lambda0, double lambda_dot, double lambda_ddot, double chartimescale, double minsunelong, double maxsunelong, double min_proj_sine, double maxheliodist, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int verbose);
+int trk2statevane_fgfunc(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, const vector <double> &trkelong, double lambda0, double lambda_dot, double lambda_ddot, double chartimescale, double minsunelong, double maxsunelong, double min_proj_sine, double maxheliodist, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf);
+int trk2statevane_univar(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, const vector <point3d> &trkunit, const vector <double> &trkelong, double lambda0, double lambda_dot, double lambda_ddot, double chartimescale, double minsunelong, double maxsunelong, double min_proj_sine, double maxheliodist, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar, double max_v_inf, int verbose);
 void lastroot(const vector <double> &intvec, vector <double> &rootvec, long N);
 int trk2statevec_omp(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar);
 int trk2statevec_omp2(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, double heliodist, double heliovel, double helioacc, double chartimescale, vector <point6ix2> &allstatevecs, double mjdref, double mingeoobs, double minimpactpar);
@@ -2004,11 +2217,18 @@ long intvec_findplace(const vector <vector <long>> &imat, const vector <long> &i
 long blend_vector(vector<long> vec);
 int form_clusters_kd2(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
 int form_clusters_kd3(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
+int tracklet_nightmask(const vector <hlimage> &image_log, const vector <tracklet> &tracklets, vector <unsigned long> &trkmask, int &nightnum);
+long coarse_cellkey(const point6ix2 &point, long cellsize, int dx, int dy, int dz);
+int coarse_cluster_screen(const vector <point6ix2> &statevecs, const vector <unsigned long> &trkmask, long cellsize, int npt, int minobsnights, vector <point6ix2> &keptvecs, int verbose);
 int form_clusters_kd4(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
+int form_clusters_kd5(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, const vector <unsigned long> &trkmask, int prescreen, long &screen_in, long &screen_kept, long firstnew, int verbose);
+int form_clusters_kd6(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, const vector <unsigned long> &trkmask, int prescreen, long &screen_in, long &screen_kept, long firstnew, hlhypstat &hypstat, int verbose);
 int highgrade_kdpairs(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <long> &linkdet_indices, double cluster_radius, double clustchangerad, double npt, long minobsnum, double mintimespan, double mingeodist, double geologstep, double maxgeodist, int verbose);
 vector <long> uintvec2long(vector <unsigned int> uivec);
 int form_clusters_kd4_lowmem(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, long hypindex, double chartimescale, vector <shortclust> &outclust, vector <uint_pair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
 int form_clusters_RR(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
+int form_clusters_kd5_lowmem(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, long hypindex, double chartimescale, vector <shortclust> &outclust, vector <uint_pair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int compact, int verbose);
+int form_clusters_kd6_lowmem(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, long hypindex, double chartimescale, vector <shortclust> &outclust, vector <uint_pair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int compact, hlhypstat &hypstat, int verbose);
 int form_clusters_RR_lowmem(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, long hypindex, double chartimescale, vector <shortclust> &outclust, vector <uint_pair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double dbscan_npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
 int form_clusters_kdR(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, double chartimescale, vector <hlclust> &outclust, vector <longpair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
 int form_clusters_kdR_lowmem(const vector <point6ix2> &allstatevecs, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const point3d &Earthrefpos, double reference_MJD, double heliodist, double heliovel, double helioacc, long hypindex, double chartimescale, vector <shortclust> &outclust, vector <uint_pair> &clust2det, long &realclusternum, double cluster_radius, double clustchangerad, double npt, double mingeodist, double geologstep, double maxgeodist, int mintimespan, int minobsnights, int verbose);
@@ -2019,6 +2239,7 @@ int heliolinc_alg_danby(const vector <hlimage> &image_log, const vector <hldet>
 int heliovane_alg_danby(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &lambdahyp, const vector <EarthState> &earthpos, HeliovaneConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int heliovane_alg_all(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &lambdahyp, const vector <EarthState> &earthpos, HeliovaneConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int heliolinc_alg_lowmem(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
+int heliolinc_alg_lowmem2(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det, vector <hlhypstat> &hypstats);
 int heliolinc_highgrade(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, long minobsnum, vector <hldet> &outdet);
 int heliolinc_highgrade2(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, long minobsnum, vector <hldet> &outdet);
 int heliolinc_alg_omp(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
@@ -2027,7 +2248,11 @@ int heliolinc_alg_omp3(const vector <hlimage> &image_log, const vector <hldet> &
 int heliolinc_alg_ompdanby(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int heliolinc_alg_ompkd(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int heliolinc_alg_ompkd3(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
+int merge_cluster_buffers(vector <vector <hlclust>> &clust_mat, vector <vector <longpair>> &clust2det_mat, vector <hlclust> &outclust, vector <longpair> &clust2det);
+int merge_cluster_buffers_ind(vector <vector <hlclust>> &clust_mat, vector <vector <vector <long>>> &clustind_mat, vector <hlclust> &outclust, vector <vector <long>> &clustindmat);
 int link_dedup(const vector <hlclust> &inclust, const vector  <longpair> &inclust2det, vector <hlclust> &outclust, vector  <longpair> &outclust2det);
+int link_dedup_index(const vector <hlclust> &inclust, const vector  <longpair> &inclust2det, vector <hlclust> &outclust, vector  <longpair> &outclust2det, vector <long> &keptind);
+int link_recall_compare(const vector <hlclust> &refclust, const vector <longpair> &refclust2det, const vector <hlclust> &testclust, const vector <longpair> &testclust2det, long &matchnum, long &missnum, long &extranum);
 int link_dedup_lowmem(const vector <shortclust> &inclust, const vector  <uint_pair> &inclust2det, vector <shortclust> &outclust, vector  <uint_pair> &outclust2det);
 int link_dedup_lowmem2(const vector <shortclust> &inclust, const vector  <uint_pair> &inclust2det, vector <shortclust> &outclust, vector  <uint_pair> &outclust2det);
 int heliolinc_alg_ompkd4(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
@@ -2036,6 +2261,11 @@ int heliolinc_alg_RR(const vector <hlimage> &image_log, const vector <hldet> &de
 int heliolinc_alg_R(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int heliolinc_alg_all(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int heliolinc_omp_all(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
+int heliolinc_omp_all2(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det, vector <hlhypstat> &hypstats);
+int write_hypstat_file(const string &outfile, const vector <hlhypstat> &hypstats);
+int heliolinc_stream_window(const vector <hlimage> &old_images, const vector <hldet> &old_dets, const vector <tracklet> &old_tracklets, const vector <longpair> &old_trk2det, const vector <hlimage> &new_images, const vector <hldet> &new_dets, const vector <tracklet> &new_tracklets, const vector <longpair> &new_trk2det, double cutoffMJD, vector <hlimage> &image_log, vector <hldet> &detvec, vector <tracklet> &tracklets, vector <longpair> &trk2det, vector <vector <point6ix2>> &hypstate, long &firstnew);
+int heliolinc_alg_stream(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, long firstcompute, long firstnew, const vector <hlradhyp> &radhyp, const vector <EarthState> &earthpos, HeliolincConfig config, double chartimescale, vector <vector <point6ix2>> &hypstate, vector <hlclust> &outclust, vector <longpair> &clust2det);
+int heliohyp_adapt(const vector <hlradhyp> &radhyp, const vector <hlclust> &inclust, const vector <double> &hypcost, double completeness, double costbudget, double refinefrac, int pureonly, vector <hlradhyp> &outhyp, int verbose);
 int heliovane_alg_ompdanby(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <tracklet> &tracklets, const vector <longpair> &trk2det, const vector <hlradhyp> &lambdahyp, const vector <EarthState> &earthpos, HeliovaneConfig config, vector <hlclust> &outclust, vector <longpair> &clust2det);
 int link_refine_Herget(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <hlclust> &inclust, const vector  <longpair> &inclust2det, LinkRefineConfig config, vector <hlclust> &outclust, vector <longpair> &outclust2det);
 int link_refine_Herget_univar(const vector <hlimage> &image_log, const vector <hldet> &detvec, const vector <hlclust> &inclust, const vector  <longpair> &inclust2det, LinkRefineConfig config, vector <hlclust> &outclust, vector <longpair> &outclust2det, int verbose);
@@ -2112,3 +2342,13 @@ int packepoch2MJD(string epochstring, double &mjd);
 double heliojul01(double MJD,double RA, double Dec);
 int sunradec_approx01(double MJD,double &sunra, double &sundec);
 int unpack_objstring(string packstring, string &unpackstring);
+void hlprof_enable(int enable);
+int hlprof_enabled();
+void hlprof_reset();
+hlprof_entry *hlprof_lookup(const string &name, int sample_rss=0);
+void hlprof_count(hlprof_entry *entry, long n);
+long hlprof_peak_rss_kb();
+int hlprof_write(const string &outfile, const string &program);
+void hllog_set_level(int level);
+int hllog_level();
+void hllog_write(int level, const string &message);